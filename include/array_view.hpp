@@ -409,6 +409,260 @@ private:
 };
 // }}}
 
+// mutable_array_view {{{
+
+// Writable counterpart of array_view.  It refers to the same kinds of arrays
+// but yields non-const access and converts implicitly to array_view.
+template<class T>
+class mutable_array_view {
+public:
+    /*
+     * types
+     */
+    typedef T value_type;
+    typedef value_type* pointer;
+    typedef value_type const* const_pointer;
+    typedef value_type& reference;
+    typedef value_type const& const_reference;
+    typedef value_type* iterator;
+    typedef value_type const* const_iterator;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    /*
+     * ctors and assign operators
+     */
+    constexpr mutable_array_view() noexcept
+        : length_(0), data_(nullptr)
+    {}
+
+    constexpr mutable_array_view(mutable_array_view const&) noexcept = default;
+    constexpr mutable_array_view(mutable_array_view &&) noexcept = default;
+
+    template<size_type N>
+    /*implicit*/ mutable_array_view(std::array<T, N> & a) noexcept
+        : length_(N), data_(N > 0 ? a.data() : nullptr)
+    {}
+
+    template<size_type N>
+    /*implicit*/ mutable_array_view(T (& a)[N]) noexcept
+        : length_(N), data_(N > 0 ? std::addressof(a[0]) : nullptr)
+    {
+        static_assert(N > 0, "Zero-length array is not permitted in ISO C++.");
+    }
+
+    template<size_type N>
+    /*implicit*/ mutable_array_view(boost::array<T, N> & a) noexcept
+        : length_(N), data_(a.data())
+    {}
+
+    /*implicit*/ mutable_array_view(std::vector<T> & v) noexcept
+        : length_(v.size()), data_(v.empty() ? nullptr : v.data())
+    {}
+
+    /*implicit*/ constexpr mutable_array_view(T* a, size_type const n) noexcept
+        : length_(n), data_(a)
+    {}
+
+    // Only pointers are accepted, other iterators may not refer to contiguous
+    // memory.  A template, so that {p, 0} is not ambiguous with (T*, size_type).
+    template<
+        class Pointer,
+        class = typename std::enable_if<
+            std::is_same<Pointer, T*>::value
+        >::type
+    >
+    explicit constexpr mutable_array_view(Pointer start, Pointer last) noexcept
+        : length_(static_cast<size_type>(last - start)), data_(start)
+    {}
+
+    mutable_array_view& operator=(mutable_array_view const&) noexcept = delete;
+    mutable_array_view& operator=(mutable_array_view &&) noexcept = delete;
+
+    /*implicit*/ constexpr operator array_view<T>() const noexcept
+    {
+        return array_view<T>{data_, length_};
+    }
+
+    /*
+     * iterator interfaces
+     */
+    constexpr iterator begin() const noexcept
+    {
+        return data_;
+    }
+    constexpr iterator end() const noexcept
+    {
+        return data_ + length_;
+    }
+    constexpr const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    constexpr const_iterator cend() const noexcept
+    {
+        return end();
+    }
+    reverse_iterator rbegin() const
+    {
+        return reverse_iterator{end()};
+    }
+    reverse_iterator rend() const
+    {
+        return reverse_iterator{begin()};
+    }
+    const_reverse_iterator crbegin() const
+    {
+        return const_reverse_iterator{cend()};
+    }
+    const_reverse_iterator crend() const
+    {
+        return const_reverse_iterator{cbegin()};
+    }
+
+    /*
+     * access
+     */
+    constexpr size_type size() const noexcept
+    {
+        return length_;
+    }
+    constexpr size_type length() const noexcept
+    {
+        return size();
+    }
+    constexpr size_type max_size() const noexcept
+    {
+        return size();
+    }
+    constexpr bool empty() const noexcept
+    {
+        return length_ == 0;
+    }
+    constexpr reference operator[](size_type const n) const noexcept
+    {
+        return *(data_ + n);
+    }
+    constexpr reference at(size_type const n) const
+    {
+        return (n >= length_)
+            ? throw std::out_of_range("mutable_array_view::at()")
+            : *(data_ + n);
+    }
+    constexpr pointer data() const noexcept
+    {
+        return data_;
+    }
+    constexpr reference front() const noexcept
+    {
+        return *data_;
+    }
+    constexpr reference back() const noexcept
+    {
+        return *(data_ + length_ - 1);
+    }
+
+    /*
+     * slices
+     */
+    // slice with indices {{{
+    // check bound {{{
+    constexpr mutable_array_view<T> slice(check_bound_t, size_type const pos, size_type const length) const
+    {
+        return (pos >= length_ || pos + length >= length_)
+            ? throw std::out_of_range("mutable_array_view::slice()")
+            : mutable_array_view<T>{begin() + pos, length};
+    }
+    constexpr mutable_array_view<T> slice_before(check_bound_t, size_type const pos) const
+    {
+        return (pos >= length_)
+            ? throw std::out_of_range("mutable_array_view::slice()")
+            : mutable_array_view<T>{begin(), pos};
+    }
+    constexpr mutable_array_view<T> slice_after(check_bound_t, size_type const pos) const
+    {
+        return (pos >= length_)
+            ? throw std::out_of_range("mutable_array_view::slice()")
+            : mutable_array_view<T>{begin() + pos, length_ - pos};
+    }
+    // }}}
+    // not check bound {{{
+    constexpr mutable_array_view<T> slice(size_type const pos, size_type const length) const
+    {
+        return mutable_array_view<T>{begin() + pos, length};
+    }
+    constexpr mutable_array_view<T> slice_before(size_type const pos) const
+    {
+        return mutable_array_view<T>{begin(), pos};
+    }
+    constexpr mutable_array_view<T> slice_after(size_type const pos) const
+    {
+        return mutable_array_view<T>{begin() + pos, length_ - pos};
+    }
+    // }}}
+    // }}}
+    // slice with iterators {{{
+    // check bound {{{
+    constexpr mutable_array_view<T> slice(check_bound_t, iterator start, iterator last) const
+    {
+        return (start >= end() || last > end() || start > last)
+            ? throw std::out_of_range("mutable_array_view::slice()")
+            : mutable_array_view<T>{start, static_cast<size_type>(last - start)};
+    }
+    constexpr mutable_array_view<T> slice_before(check_bound_t, iterator const pos) const
+    {
+        return (pos < begin() || pos > end())
+            ? throw std::out_of_range("mutable_array_view::slice()")
+            : mutable_array_view<T>{begin(), static_cast<size_type>(pos - begin())};
+    }
+    constexpr mutable_array_view<T> slice_after(check_bound_t, iterator const pos) const
+    {
+        return (pos < begin() || pos > end())
+            ? throw std::out_of_range("mutable_array_view::slice()")
+            : mutable_array_view<T>{pos, static_cast<size_type>(end() - pos)};
+    }
+    // }}}
+    // not check bound {{{
+    constexpr mutable_array_view<T> slice(iterator start, iterator last) const
+    {
+        return mutable_array_view<T>{start, static_cast<size_type>(last - start)};
+    }
+    constexpr mutable_array_view<T> slice_before(iterator const pos) const
+    {
+        return mutable_array_view<T>{begin(), static_cast<size_type>(pos - begin())};
+    }
+    constexpr mutable_array_view<T> slice_after(iterator const pos) const
+    {
+        return mutable_array_view<T>{pos, static_cast<size_type>(end() - pos)};
+    }
+    // }}}
+    // }}}
+
+    /*
+     * others
+     */
+    template<class Allocator = std::allocator<T>>
+    auto to_vector(Allocator const& alloc = Allocator{}) const
+        -> std::vector<T, Allocator>
+    {
+        return {begin(), end(), alloc};
+    }
+
+    template<size_t N>
+    auto to_array() const
+        -> std::array<T, N>
+    {
+        return array_view<T>(*this).template to_array<N>();
+    }
+
+private:
+    size_type const length_;
+    pointer const data_;
+};
+// }}}
+
 // compare operators {{{
 namespace detail {
     template< class ArrayL, class ArrayR, class IterL, class IterR>
@@ -500,6 +754,60 @@ bool operator!=(Array const& lhs, array_view<T> const& rhs)
 {
     return !(rhs == lhs);
 }
+
+template<class T, class Rhs>
+inline constexpr
+bool operator==(mutable_array_view<T> const& lhs, Rhs const& rhs)
+{
+    return array_view<T>(lhs) == rhs;
+}
+
+template<class T1, class T2>
+inline constexpr
+bool operator==(array_view<T1> const& lhs, mutable_array_view<T2> const& rhs)
+{
+    return lhs == array_view<T2>(rhs);
+}
+
+template<
+    class Array,
+    class T,
+    class = typename std::enable_if<
+        is_array<Array>::value
+    >::type
+>
+inline constexpr
+bool operator==(Array const& lhs, mutable_array_view<T> const& rhs)
+{
+    return array_view<T>(rhs) == lhs;
+}
+
+template<class T, class Rhs>
+inline constexpr
+bool operator!=(mutable_array_view<T> const& lhs, Rhs const& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<class T1, class T2>
+inline constexpr
+bool operator!=(array_view<T1> const& lhs, mutable_array_view<T2> const& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<
+    class Array,
+    class T,
+    class = typename std::enable_if<
+        is_array<Array>::value
+    >::type
+>
+inline constexpr
+bool operator!=(Array const& lhs, mutable_array_view<T> const& rhs)
+{
+    return !(rhs == lhs);
+}
 // }}}
 
 // helpers to construct view {{{
@@ -543,6 +851,40 @@ array_view<T> make_view(std::initializer_list<T> const& l)
 {
     return {l};
 }
+
+template<
+    class Array,
+    class = typename std::enable_if<
+        detail::is_array_class<Array>::value
+    >::type
+>
+inline
+auto make_mutable_view(Array & a)
+    -> mutable_array_view<typename Array::value_type>
+{
+    return {a};
+}
+
+template< class T, size_t N>
+inline
+mutable_array_view<T> make_mutable_view(T (&a)[N])
+{
+    return {a};
+}
+
+template<class T>
+inline constexpr
+mutable_array_view<T> make_mutable_view(T* p, typename mutable_array_view<T>::size_type const n)
+{
+    return mutable_array_view<T>{p, n};
+}
+
+template<class T>
+inline constexpr
+mutable_array_view<T> make_mutable_view(T* begin, T* end)
+{
+    return mutable_array_view<T>{begin, end};
+}
 // }}}
 
 } // namespace arv
@@ -0,0 +1,313 @@
+#if !defined ARV_ARRAY_VIEW_ALGORITHM_HPP_INCLUDED
+#define      ARV_ARRAY_VIEW_ALGORITHM_HPP_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "array_view.hpp"
+
+namespace arv {
+
+namespace detail {
+    // radix keys {{{
+    template<size_t Size>
+    struct unsigned_of_size;
+    template<>
+    struct unsigned_of_size<1> {
+        typedef std::uint8_t type;
+    };
+    template<>
+    struct unsigned_of_size<2> {
+        typedef std::uint16_t type;
+    };
+    template<>
+    struct unsigned_of_size<4> {
+        typedef std::uint32_t type;
+    };
+    template<>
+    struct unsigned_of_size<8> {
+        typedef std::uint64_t type;
+    };
+
+    // Maps T to an unsigned integer whose order matches the order of T.
+    template<class T, class = void>
+    struct radix_key;
+
+    template<class T>
+    struct radix_key<
+        T,
+        typename std::enable_if<
+            std::is_integral<T>::value && !std::is_same<T, bool>::value
+        >::type
+    > {
+        typedef typename unsigned_of_size<sizeof(T)>::type type;
+
+        static type get(T const t) noexcept
+        {
+            return std::is_signed<T>::value
+                ? static_cast<type>(static_cast<type>(t) ^ (type{1} << (sizeof(T) * 8 - 1)))
+                : static_cast<type>(t);
+        }
+    };
+
+    // Negative values have all bits flipped, positive values only the sign bit.
+    // -0.0 is ordered before +0.0 and NaNs are ordered by their bits.
+    template<class T>
+    struct radix_key<
+        T,
+        typename std::enable_if<
+            std::is_floating_point<T>::value && std::numeric_limits<T>::is_iec559
+        >::type
+    > {
+        typedef typename unsigned_of_size<sizeof(T)>::type type;
+
+        static type get(T const t) noexcept
+        {
+            type bits;
+            std::memcpy(&bits, &t, sizeof(T));
+            type const sign = type{1} << (sizeof(T) * 8 - 1);
+            return (bits & sign) ? static_cast<type>(~bits) : static_cast<type>(bits | sign);
+        }
+    };
+
+    static constexpr size_t radix_bits = 8;
+    static constexpr size_t radix_size = size_t{1} << radix_bits;
+
+    template<class T>
+    inline size_t radix_digit(T const& t, size_t const pass) noexcept
+    {
+        return static_cast<size_t>(radix_key<T>::get(t) >> (pass * radix_bits)) & (radix_size - 1);
+    }
+
+    // Below this size a comparison sort beats the radix passes.
+    static constexpr size_t radix_sort_threshold = 64;
+
+    template<class T>
+    inline void small_radix_sort(T* const first, T* const last)
+    {
+        std::sort(first, last, [](T const& a, T const& b) {
+            return radix_key<T>::get(a) < radix_key<T>::get(b);
+        });
+    }
+    // }}}
+
+    // Runs f(0) ... f(n - 1) on n threads, f(0) on the calling thread.
+    template<class F>
+    inline void run_parallel(unsigned const n, F const& f)
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(n - 1);
+        for (unsigned t = 1; t < n; ++t) {
+            workers.emplace_back(f, t);
+        }
+        f(0);
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    template<class T>
+    inline void check_scratch(mutable_array_view<T> const& v, mutable_array_view<T> const& scratch, char const* const what)
+    {
+        if (scratch.size() < v.size()) {
+            throw std::invalid_argument(what);
+        }
+    }
+} // namespace detail
+
+// radix sort {{{
+
+// Sorts integer or floating point values in ascending order with an LSD
+// radix sort.  scratch must hold at least v.size() elements.
+template<class T>
+void radix_sort(mutable_array_view<T> const& v, mutable_array_view<T> const& scratch)
+{
+    detail::check_scratch(v, scratch, "radix_sort(): scratch buffer is too small");
+
+    size_t const n = v.size();
+    if (n <= detail::radix_sort_threshold) {
+        detail::small_radix_sort(v.begin(), v.end());
+        return;
+    }
+
+    static constexpr size_t passes = sizeof(T);
+    std::array<std::array<size_t, detail::radix_size>, passes> counts{};
+    for (auto const& x : v) {
+        for (size_t p = 0; p < passes; ++p) {
+            ++counts[p][detail::radix_digit(x, p)];
+        }
+    }
+
+    T* src = v.data();
+    T* dst = scratch.data();
+    for (size_t p = 0; p < passes; ++p) {
+        auto& offsets = counts[p];
+        // All elements share this digit, the pass would not move anything.
+        if (offsets[detail::radix_digit(src[0], p)] == n) {
+            continue;
+        }
+        size_t sum = 0;
+        for (auto& o : offsets) {
+            size_t const c = o;
+            o = sum;
+            sum += c;
+        }
+        for (T const* i = src; i != src + n; ++i) {
+            dst[offsets[detail::radix_digit(*i, p)]++] = *i;
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != v.data()) {
+        std::copy(src, src + n, v.data());
+    }
+}
+
+template<class T>
+void radix_sort(mutable_array_view<T> const& v)
+{
+    std::vector<T> scratch(v.size());
+    radix_sort(v, mutable_array_view<T>{scratch});
+}
+
+// Same as radix_sort() but every pass is split over threads.  If threads is 0,
+// std::thread::hardware_concurrency() threads are used.
+template<class T>
+void parallel_radix_sort(mutable_array_view<T> const& v, mutable_array_view<T> const& scratch, unsigned threads = 0)
+{
+    detail::check_scratch(v, scratch, "parallel_radix_sort(): scratch buffer is too small");
+
+    // Each thread should get enough elements to amortize its start.
+    static constexpr size_t min_chunk = size_t{1} << 16;
+
+    size_t const n = v.size();
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads = static_cast<unsigned>(std::min<size_t>(threads, n / min_chunk));
+    if (threads <= 1) {
+        radix_sort(v, scratch);
+        return;
+    }
+
+    static constexpr size_t passes = sizeof(T);
+    typedef std::array<size_t, detail::radix_size> histogram;
+    std::vector<histogram> counts(threads);
+
+    auto const chunk_begin = [n, threads](unsigned const t) {
+        return n * t / threads;
+    };
+
+    T* src = v.data();
+    T* dst = scratch.data();
+    for (size_t p = 0; p < passes; ++p) {
+        detail::run_parallel(threads, [&](unsigned const t) {
+            auto& c = counts[t];
+            c.fill(0);
+            for (size_t i = chunk_begin(t), e = chunk_begin(t + 1); i != e; ++i) {
+                ++c[detail::radix_digit(src[i], p)];
+            }
+        });
+
+        // Digit d of thread t starts after all smaller digits and after digit d of all previous threads.
+        size_t sum = 0;
+        bool skip = false;
+        for (size_t d = 0; d < detail::radix_size; ++d) {
+            size_t const start = sum;
+            for (auto& c : counts) {
+                size_t const cnt = c[d];
+                c[d] = sum;
+                sum += cnt;
+            }
+            skip = skip || sum - start == n;
+        }
+        if (skip) {
+            continue;
+        }
+
+        detail::run_parallel(threads, [&](unsigned const t) {
+            auto& offsets = counts[t];
+            for (size_t i = chunk_begin(t), e = chunk_begin(t + 1); i != e; ++i) {
+                dst[offsets[detail::radix_digit(src[i], p)]++] = src[i];
+            }
+        });
+        std::swap(src, dst);
+    }
+
+    if (src != v.data()) {
+        detail::run_parallel(threads, [&](unsigned const t) {
+            std::copy(src + chunk_begin(t), src + chunk_begin(t + 1), v.data() + chunk_begin(t));
+        });
+    }
+}
+
+template<class T>
+void parallel_radix_sort(mutable_array_view<T> const& v, unsigned const threads = 0)
+{
+    std::vector<T> scratch(v.size());
+    parallel_radix_sort(v, mutable_array_view<T>{scratch}, threads);
+}
+// }}}
+
+// partition {{{
+
+// Moves elements satisfying pred before the others, preserving the relative
+// order in both groups.  Returns the beginning of the second group.
+// scratch must hold at least v.size() elements.
+template<class T, class Predicate>
+auto stable_partition(mutable_array_view<T> const& v, mutable_array_view<T> const& scratch, Predicate pred)
+    -> typename mutable_array_view<T>::iterator
+{
+    detail::check_scratch(v, scratch, "stable_partition(): scratch buffer is too small");
+
+    auto out = v.begin();
+    auto rest = scratch.begin();
+    for (auto i = v.begin(); i != v.end(); ++i) {
+        if (pred(*i)) {
+            if (out != i) {
+                *out = std::move(*i);
+            }
+            ++out;
+        } else {
+            *rest++ = std::move(*i);
+        }
+    }
+    std::move(scratch.begin(), rest, out);
+    return out;
+}
+
+template<class T, class Predicate>
+auto stable_partition(mutable_array_view<T> const& v, Predicate pred)
+    -> typename mutable_array_view<T>::iterator
+{
+    return std::stable_partition(v.begin(), v.end(), pred);
+}
+// }}}
+
+// selection {{{
+
+// Rearranges v so that v[n] is the element which would be there if v was
+// sorted, no element before it is greater and no element after it is less.
+// Throws std::out_of_range if n is not an index of v.
+template<class T, class Compare = std::less<T>>
+void nth_element(mutable_array_view<T> const& v, typename mutable_array_view<T>::size_type const n, Compare comp = Compare{})
+{
+    if (n >= v.size()) {
+        throw std::out_of_range("nth_element()");
+    }
+    std::nth_element(v.begin(), v.begin() + n, v.end(), comp);
+}
+// }}}
+
+} // namespace arv
+
+#endif    // ARV_ARRAY_VIEW_ALGORITHM_HPP_INCLUDED
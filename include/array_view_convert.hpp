@@ -0,0 +1,939 @@
+#if !defined ARV_ARRAY_VIEW_CONVERT_HPP_INCLUDED
+#define      ARV_ARRAY_VIEW_CONVERT_HPP_INCLUDED
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined __SSE2__
+#include <emmintrin.h>
+#endif
+#if defined __F16C__
+#include <immintrin.h>
+#endif
+
+#include "array_view.hpp"
+
+// Numeric conversions of views.
+//
+// convert_into() converts a whole view into a caller-provided buffer, with
+// SSE2 (and F16C if available) kernels for the common cases.
+// make_converted_view() returns a view which converts lazily on access.
+//
+// The SSE2 kernels cover int16 to float, float to double, float to int32,
+// int32 to int16 and float to and from float16 and bfloat16, in every mode
+// except rounding toward zero to float16 and bfloat16.  double to float
+// has a kernel only with the default mode.  Everything else is converted
+// one element at a time.
+//
+// By default values are converted as by static_cast, to float16 and bfloat16
+// they are rounded to nearest even.  The rounding mode can be chosen for
+// conversions from floating point to integers and to smaller floating point
+// types.  With saturate, finite values out of the range of the destination
+// type are clamped to it and NaN converts to 0 for integers.
+
+namespace arv {
+
+// 16 bit floating point types {{{
+
+// IEEE 754 binary16, only for storage.
+struct float16 {
+    std::uint16_t bits;
+
+    float16() = default;
+    explicit float16(float f) noexcept;
+    explicit operator float() const noexcept;
+
+    static float16 from_bits(std::uint16_t const b) noexcept
+    {
+        float16 h;
+        h.bits = b;
+        return h;
+    }
+};
+
+// The upper half of IEEE 754 binary32, only for storage.
+struct bfloat16 {
+    std::uint16_t bits;
+
+    bfloat16() = default;
+    explicit bfloat16(float f) noexcept;
+    explicit operator float() const noexcept;
+
+    static bfloat16 from_bits(std::uint16_t const b) noexcept
+    {
+        bfloat16 h;
+        h.bits = b;
+        return h;
+    }
+};
+
+enum class rounding {
+    toward_zero,
+    to_nearest_even
+};
+
+struct saturate_t {};
+static constexpr saturate_t saturate{};
+
+namespace detail {
+    inline std::uint32_t float_bits(float const f) noexcept
+    {
+        std::uint32_t u;
+        std::memcpy(&u, &f, sizeof(f));
+        return u;
+    }
+
+    inline float bits_float(std::uint32_t const u) noexcept
+    {
+        float f;
+        std::memcpy(&f, &u, sizeof(f));
+        return f;
+    }
+
+    inline std::uint16_t encode_float16(float const f, rounding const r, bool const sat) noexcept
+    {
+        std::uint32_t u = float_bits(f);
+        std::uint16_t const sign = static_cast<std::uint16_t>((u >> 16) & 0x8000);
+        u &= 0x7fffffff;
+
+        if (u >= 0x7f800000) {
+            // NaN becomes a quiet NaN with the upper bits of the payload as
+            // with F16C, infinity stays infinity.
+            return sign | (u > 0x7f800000 ? 0x7e00 | ((u >> 13) & 0x3ff) : 0x7c00);
+        }
+
+        int const e = static_cast<int>(u >> 23) - 127 + 15;
+        std::uint16_t const overflow = (sat || r == rounding::toward_zero) ? 0x7bff : 0x7c00;
+        if (e >= 31) {
+            return sign | overflow;
+        }
+
+        std::uint32_t mant;
+        int shift;
+        std::uint32_t h;
+        if (e <= 0) {
+            // Subnormal or zero
+            shift = 14 - e;
+            if (shift >= 25) {
+                return sign;
+            }
+            mant = (u & 0x7fffff) | 0x800000;
+            h = mant >> shift;
+        } else {
+            shift = 13;
+            mant = u;
+            h = (static_cast<std::uint32_t>(e) << 10) | ((u >> 13) & 0x3ff);
+        }
+
+        if (r == rounding::to_nearest_even) {
+            std::uint32_t const rem = mant & ((std::uint32_t{1} << shift) - 1);
+            std::uint32_t const half = std::uint32_t{1} << (shift - 1);
+            if (rem > half || (rem == half && (h & 1))) {
+                // A carry into the exponent is the correctly rounded result.
+                ++h;
+            }
+        }
+        return sign | static_cast<std::uint16_t>(h >= 0x7c00 ? overflow : h);
+    }
+
+    inline float decode_float16(std::uint16_t const h) noexcept
+    {
+        std::uint32_t const sign = static_cast<std::uint32_t>(h & 0x8000) << 16;
+        std::uint32_t e = (h >> 10) & 0x1f;
+        std::uint32_t m = h & 0x3ff;
+
+        if (e == 0x1f) {
+            // NaN is quieted and keeps its payload.
+            return bits_float(sign | 0x7f800000 | (m != 0 ? 0x400000 : 0) | (m << 13));
+        }
+        if (e == 0) {
+            if (m == 0) {
+                return bits_float(sign);
+            }
+            // Normalize the subnormal value.
+            e = 1;
+            while (!(m & 0x400)) {
+                m <<= 1;
+                --e;
+            }
+            m &= 0x3ff;
+        }
+        return bits_float(sign | ((e + 112) << 23) | (m << 13));
+    }
+
+    inline std::uint16_t encode_bfloat16(float const f, rounding const r, bool const sat) noexcept
+    {
+        std::uint32_t const u = float_bits(f);
+        std::uint32_t const a = u & 0x7fffffff;
+        if (a > 0x7f800000) {
+            return static_cast<std::uint16_t>((u >> 16) | 0x40);
+        }
+        if (a == 0x7f800000) {
+            return static_cast<std::uint16_t>(u >> 16);
+        }
+
+        std::uint32_t const rounded = r == rounding::to_nearest_even
+            ? u + 0x7fff + ((u >> 16) & 1)
+            : u;
+        std::uint16_t const h = static_cast<std::uint16_t>(rounded >> 16);
+        if ((h & 0x7f80) == 0x7f80 && sat) {
+            return static_cast<std::uint16_t>((h & 0x8000) | 0x7f7f);
+        }
+        return h;
+    }
+
+    inline float decode_bfloat16(std::uint16_t const h) noexcept
+    {
+        return bits_float(static_cast<std::uint32_t>(h) << 16);
+    }
+
+    template<class T>
+    struct is_floating_like {
+        static bool const value = std::is_floating_point<T>::value
+            || std::is_same<T, float16>::value
+            || std::is_same<T, bfloat16>::value;
+    };
+
+    template<class From, class To>
+    constexpr rounding default_rounding() noexcept
+    {
+        return (is_floating_like<From>::value && std::is_integral<To>::value)
+            ? rounding::toward_zero
+            : rounding::to_nearest_even;
+    }
+} // namespace detail
+
+inline float16::float16(float const f) noexcept
+    : bits(detail::encode_float16(f, rounding::to_nearest_even, false))
+{}
+
+inline float16::operator float() const noexcept
+{
+    return detail::decode_float16(bits);
+}
+
+inline bfloat16::bfloat16(float const f) noexcept
+    : bits(detail::encode_bfloat16(f, rounding::to_nearest_even, false))
+{}
+
+inline bfloat16::operator float() const noexcept
+{
+    return detail::decode_bfloat16(bits);
+}
+// }}}
+
+namespace detail {
+    // scalar conversion {{{
+    template<class From, class To, class = void>
+    struct convert_one;
+
+    // float16 and bfloat16 convert through float, so double is rounded twice.
+    template<class From>
+    struct convert_one<From, float16, typename std::enable_if<!std::is_same<From, float16>::value>::type> {
+        static float16 apply(From const x, rounding const r, bool const sat) noexcept
+        {
+            return float16::from_bits(encode_float16(convert_one<From, float>::apply(x, r, sat), r, sat));
+        }
+    };
+
+    template<class From>
+    struct convert_one<From, bfloat16, typename std::enable_if<!std::is_same<From, bfloat16>::value>::type> {
+        static bfloat16 apply(From const x, rounding const r, bool const sat) noexcept
+        {
+            return bfloat16::from_bits(encode_bfloat16(convert_one<From, float>::apply(x, r, sat), r, sat));
+        }
+    };
+
+    template<class To>
+    struct convert_one<
+        float16,
+        To,
+        typename std::enable_if<!std::is_same<To, bfloat16>::value>::type
+    > {
+        static To apply(float16 const x, rounding const r, bool const sat) noexcept
+        {
+            return convert_one<float, To>::apply(decode_float16(x.bits), r, sat);
+        }
+    };
+
+    template<class To>
+    struct convert_one<
+        bfloat16,
+        To,
+        typename std::enable_if<!std::is_same<To, float16>::value>::type
+    > {
+        static To apply(bfloat16 const x, rounding const r, bool const sat) noexcept
+        {
+            return convert_one<float, To>::apply(decode_bfloat16(x.bits), r, sat);
+        }
+    };
+
+    template<>
+    struct convert_one<float16, bfloat16> {
+        static bfloat16 apply(float16 const x, rounding const r, bool const sat) noexcept
+        {
+            return bfloat16::from_bits(encode_bfloat16(decode_float16(x.bits), r, sat));
+        }
+    };
+
+    template<>
+    struct convert_one<bfloat16, float16> {
+        static float16 apply(bfloat16 const x, rounding const r, bool const sat) noexcept
+        {
+            return float16::from_bits(encode_float16(decode_bfloat16(x.bits), r, sat));
+        }
+    };
+
+    // floating point to integer
+    template<class From, class To>
+    struct convert_one<
+        From,
+        To,
+        typename std::enable_if<std::is_floating_point<From>::value && std::is_integral<To>::value>::type
+    > {
+        static To apply(From const x, rounding const r, bool const sat) noexcept
+        {
+            From const v = r == rounding::to_nearest_even ? std::nearbyint(x) : std::trunc(x);
+            if (sat) {
+                // The limits of To are powers of two or one less, so the casts are exact or round up to 2^n.
+                if (std::isnan(v)) {
+                    return To{0};
+                }
+                if (v <= static_cast<From>(std::numeric_limits<To>::min())) {
+                    return std::numeric_limits<To>::min();
+                }
+                if (v >= static_cast<From>(std::numeric_limits<To>::max())) {
+                    return std::numeric_limits<To>::max();
+                }
+            }
+            return static_cast<To>(v);
+        }
+    };
+
+    // integer to integer
+    template<class From, class To>
+    struct convert_one<
+        From,
+        To,
+        typename std::enable_if<std::is_integral<From>::value && std::is_integral<To>::value>::type
+    > {
+        static To apply(From const x, rounding, bool const sat) noexcept
+        {
+            if (sat) {
+                if (std::is_signed<From>::value && x < 0) {
+                    if (!std::is_signed<To>::value) {
+                        return To{0};
+                    }
+                    if (static_cast<std::intmax_t>(x) < static_cast<std::intmax_t>(std::numeric_limits<To>::min())) {
+                        return std::numeric_limits<To>::min();
+                    }
+                } else if (static_cast<std::uintmax_t>(x) > static_cast<std::uintmax_t>(std::numeric_limits<To>::max())) {
+                    return std::numeric_limits<To>::max();
+                }
+            }
+            return static_cast<To>(x);
+        }
+    };
+
+    // floating point to floating point
+    template<class From, class To>
+    struct convert_one<
+        From,
+        To,
+        typename std::enable_if<std::is_floating_point<From>::value && std::is_floating_point<To>::value>::type
+    > {
+        static To apply(From const x, rounding const r, bool const sat) noexcept
+        {
+            To f = static_cast<To>(x);
+            if (sizeof(To) < sizeof(From) && std::isfinite(x)) {
+                if (r == rounding::toward_zero && std::fabs(static_cast<From>(f)) > std::fabs(x)) {
+                    f = std::nextafter(f, To{0});
+                }
+                if (sat && std::isinf(f)) {
+                    f = std::copysign(std::numeric_limits<To>::max(), f);
+                }
+            }
+            return f;
+        }
+    };
+
+    // integer to floating point
+    template<class From, class To>
+    struct convert_one<
+        From,
+        To,
+        typename std::enable_if<std::is_integral<From>::value && std::is_floating_point<To>::value>::type
+    > {
+        static To apply(From const x, rounding, bool) noexcept
+        {
+            return static_cast<To>(x);
+        }
+    };
+    // }}}
+
+    // bulk conversion {{{
+    template<class From, class To>
+    inline void convert_scalar(From const* const src, To* const dst, size_t const n, rounding const r, bool const sat)
+    {
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = convert_one<From, To>::apply(src[i], r, sat);
+        }
+    }
+
+    // Specializations convert a prefix of the input with SIMD and the rest,
+    // as well as modes they don't support, with convert_scalar().
+    template<class From, class To>
+    struct converter {
+        static void run(From const* const src, To* const dst, size_t const n, rounding const r, bool const sat)
+        {
+            convert_scalar(src, dst, n, r, sat);
+        }
+    };
+
+#if defined __SSE2__
+    template<>
+    struct converter<std::int16_t, float> {
+        static void run(std::int16_t const* const src, float* const dst, size_t const n, rounding const r, bool const sat)
+        {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+                // Sign extend by moving each value to the upper half and shifting it back.
+                __m128i const lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+                __m128i const hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+                _mm_storeu_ps(dst + i, _mm_cvtepi32_ps(lo));
+                _mm_storeu_ps(dst + i + 4, _mm_cvtepi32_ps(hi));
+            }
+            convert_scalar(src + i, dst + i, n - i, r, sat);
+        }
+    };
+
+    template<>
+    struct converter<float, double> {
+        static void run(float const* const src, double* const dst, size_t const n, rounding const r, bool const sat)
+        {
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m128 const v = _mm_loadu_ps(src + i);
+                _mm_storeu_pd(dst + i, _mm_cvtps_pd(v));
+                _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+            }
+            convert_scalar(src + i, dst + i, n - i, r, sat);
+        }
+    };
+
+    template<>
+    struct converter<double, float> {
+        static void run(double const* const src, float* const dst, size_t const n, rounding const r, bool const sat)
+        {
+            size_t i = 0;
+            if (r == rounding::to_nearest_even && !sat) {
+                for (; i + 4 <= n; i += 4) {
+                    __m128 const lo = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+                    __m128 const hi = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+                    _mm_storeu_ps(dst + i, _mm_movelh_ps(lo, hi));
+                }
+            }
+            convert_scalar(src + i, dst + i, n - i, r, sat);
+        }
+    };
+
+    // Packs the low 16 bits of each 32 bit lane of a and b.
+    inline __m128i pack_low16(__m128i const a, __m128i const b) noexcept
+    {
+        return _mm_packs_epi32(
+            _mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+            _mm_srai_epi32(_mm_slli_epi32(b, 16), 16)
+        );
+    }
+
+    inline __m128i select(__m128i const mask, __m128i const a, __m128i const b) noexcept
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    // Replaces finite floats whose magnitude is greater than the float with
+    // the bits max by that float with their sign.  NaN and infinity are kept.
+    inline __m128i clamp_finite(__m128i const u, std::uint32_t const max) noexcept
+    {
+        __m128i const abs_mask = _mm_set1_epi32(0x7fffffff);
+        __m128i const limit = _mm_set1_epi32(static_cast<int>(max));
+        __m128i const abs = _mm_and_si128(u, abs_mask);
+        __m128i const over = _mm_and_si128(
+            _mm_cmpgt_epi32(abs, limit),
+            _mm_cmplt_epi32(abs, _mm_set1_epi32(0x7f800000))
+        );
+        return select(over, _mm_or_si128(_mm_andnot_si128(abs_mask, u), limit), u);
+    }
+
+    template<>
+    struct converter<float, std::int32_t> {
+        static void run(float const* const src, std::int32_t* const dst, size_t const n, rounding const r, bool const sat)
+        {
+            // 2^31 is the first float which doesn't fit, cvtps returns INT_MIN
+            // for it and for NaN.
+            __m128 const too_big = _mm_set1_ps(2147483648.0f);
+            __m128i const max = _mm_set1_epi32(std::numeric_limits<std::int32_t>::max());
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m128 const x = _mm_loadu_ps(src + i);
+                __m128i v = r == rounding::to_nearest_even ? _mm_cvtps_epi32(x) : _mm_cvttps_epi32(x);
+                if (sat) {
+                    v = select(_mm_castps_si128(_mm_cmpge_ps(x, too_big)), max, v);
+                    v = _mm_and_si128(v, _mm_castps_si128(_mm_cmpord_ps(x, x)));
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+            }
+            convert_scalar(src + i, dst + i, n - i, r, sat);
+        }
+    };
+
+    template<>
+    struct converter<std::int32_t, std::int16_t> {
+        static void run(std::int32_t const* const src, std::int16_t* const dst, size_t const n, rounding const r, bool const sat)
+        {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m128i const lo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+                __m128i const hi = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i + 4));
+                __m128i const v = sat ? _mm_packs_epi32(lo, hi) : pack_low16(lo, hi);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+            }
+            convert_scalar(src + i, dst + i, n - i, r, sat);
+        }
+    };
+
+#if defined __F16C__
+    inline __m128i encode_float16_x4(__m128 const f) noexcept
+    {
+        return _mm_cvtepi16_epi32(_mm_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    inline __m128 decode_float16_x4(__m128i const h) noexcept
+    {
+        return _mm_cvtph_ps(pack_low16(h, h));
+    }
+#else
+    // Software versions of the scalar encode_float16() and decode_float16()
+    // for four values in the low halves of 32 bit lanes.
+    inline __m128i encode_float16_x4(__m128 const f) noexcept
+    {
+        __m128i const sign_mask = _mm_set1_epi32(static_cast<int>(0x80000000u));
+        __m128i u = _mm_castps_si128(f);
+        __m128i const sign = _mm_and_si128(u, sign_mask);
+        u = _mm_xor_si128(u, sign);
+
+        // Overflow, infinity and NaN
+        __m128i const f16_max = _mm_set1_epi32((127 + 16) << 23);
+        __m128i const is_big = _mm_cmpgt_epi32(u, _mm_sub_epi32(f16_max, _mm_set1_epi32(1)));
+        __m128i const is_nan = _mm_cmpgt_epi32(u, _mm_set1_epi32(0x7f800000));
+        __m128i const nan = _mm_or_si128(
+            _mm_and_si128(_mm_srli_epi32(u, 13), _mm_set1_epi32(0x3ff)),
+            _mm_set1_epi32(0x7e00)
+        );
+        __m128i const big = select(is_nan, nan, _mm_set1_epi32(0x7c00));
+
+        // Subnormals and zero are rounded by adding a magic number in floating point.
+        __m128i const denorm_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+        __m128i const is_small = _mm_cmplt_epi32(u, _mm_set1_epi32(113 << 23));
+        __m128i const small = _mm_sub_epi32(
+            _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(u), _mm_castsi128_ps(denorm_magic))),
+            denorm_magic
+        );
+
+        // Normal values are rounded to nearest even on the integer representation.
+        __m128i const odd = _mm_and_si128(_mm_srli_epi32(u, 13), _mm_set1_epi32(1));
+        __m128i const normal = _mm_srli_epi32(
+            _mm_add_epi32(_mm_add_epi32(u, _mm_set1_epi32(static_cast<int>(((15u - 127u) << 23) + 0xfff))), odd),
+            13
+        );
+
+        __m128i const h = select(is_big, big, select(is_small, small, normal));
+        return _mm_or_si128(h, _mm_srli_epi32(sign, 16));
+    }
+
+    inline __m128 decode_float16_x4(__m128i const h) noexcept
+    {
+        __m128i const shifted_exp = _mm_set1_epi32(0x7c00 << 13);
+        __m128i const abs = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+        __m128i u = _mm_slli_epi32(abs, 13);
+        __m128i const exp = _mm_and_si128(u, shifted_exp);
+        u = _mm_add_epi32(u, _mm_set1_epi32((127 - 15) << 23));
+
+        // Infinity and NaN get the maximum exponent.
+        __m128i const is_inf_nan = _mm_cmpeq_epi32(exp, shifted_exp);
+        u = _mm_add_epi32(u, _mm_and_si128(is_inf_nan, _mm_set1_epi32((128 - 16) << 23)));
+        __m128i const is_nan = _mm_cmpgt_epi32(abs, _mm_set1_epi32(0x7c00));
+        u = _mm_or_si128(u, _mm_and_si128(is_nan, _mm_set1_epi32(0x400000)));
+
+        // Subnormals are renormalized in floating point.
+        __m128i const is_denorm = _mm_cmpeq_epi32(exp, _mm_setzero_si128());
+        __m128i const magic = _mm_set1_epi32(113 << 23);
+        __m128i const denorm = _mm_castps_si128(_mm_sub_ps(
+            _mm_castsi128_ps(_mm_add_epi32(u, _mm_set1_epi32(1 << 23))),
+            _mm_castsi128_ps(magic)
+        ));
+        u = select(is_denorm, denorm, u);
+
+        __m128i const sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+        return _mm_castsi128_ps(_mm_or_si128(u, sign));
+    }
+#endif
+
+    template<>
+    struct converter<float, float16> {
+        static void run(float const* const src, float16* const dst, size_t const n, rounding const r, bool const sat)
+        {
+            size_t i = 0;
+            if (r == rounding::to_nearest_even) {
+                // Clamping to 65504 before rounding is the same as saturating after it.
+                auto const load = [src, sat](size_t const j) {
+                    __m128 const f = _mm_loadu_ps(src + j);
+                    return sat ? _mm_castsi128_ps(clamp_finite(_mm_castps_si128(f), 0x477fe000)) : f;
+                };
+                for (; i + 8 <= n; i += 8) {
+                    __m128i const lo = encode_float16_x4(load(i));
+                    __m128i const hi = encode_float16_x4(load(i + 4));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), pack_low16(lo, hi));
+                }
+            }
+            convert_scalar(src + i, dst + i, n - i, r, sat);
+        }
+    };
+
+    template<>
+    struct converter<float16, float> {
+        static void run(float16 const* const src, float* const dst, size_t const n, rounding const r, bool const sat)
+        {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+                __m128i const zero = _mm_setzero_si128();
+                _mm_storeu_ps(dst + i, decode_float16_x4(_mm_unpacklo_epi16(v, zero)));
+                _mm_storeu_ps(dst + i + 4, decode_float16_x4(_mm_unpackhi_epi16(v, zero)));
+            }
+            convert_scalar(src + i, dst + i, n - i, r, sat);
+        }
+    };
+
+    template<>
+    struct converter<float, bfloat16> {
+        static void run(float const* const src, bfloat16* const dst, size_t const n, rounding const r, bool const sat)
+        {
+            size_t i = 0;
+            if (r == rounding::to_nearest_even) {
+                __m128i const abs_mask = _mm_set1_epi32(0x7fffffff);
+                __m128i const inf = _mm_set1_epi32(0x7f800000);
+                __m128i const quiet = _mm_set1_epi32(0x400000);
+                __m128i const bias = _mm_set1_epi32(0x7fff);
+                __m128i const one = _mm_set1_epi32(1);
+                auto const encode = [&](__m128i const u) -> __m128i {
+                    __m128i const is_nan = _mm_cmpgt_epi32(_mm_and_si128(u, abs_mask), inf);
+                    __m128i const odd = _mm_and_si128(_mm_srli_epi32(u, 16), one);
+                    __m128i const rounded = _mm_add_epi32(_mm_add_epi32(u, bias), odd);
+                    return _mm_srli_epi32(select(is_nan, _mm_or_si128(u, quiet), rounded), 16);
+                };
+                // Values above the largest bfloat16 would round to infinity.
+                auto const load = [src, sat](size_t const j) {
+                    __m128i const u = _mm_castps_si128(_mm_loadu_ps(src + j));
+                    return sat ? clamp_finite(u, 0x7f7f0000) : u;
+                };
+                for (; i + 8 <= n; i += 8) {
+                    __m128i const lo = encode(load(i));
+                    __m128i const hi = encode(load(i + 4));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), pack_low16(lo, hi));
+                }
+            }
+            convert_scalar(src + i, dst + i, n - i, r, sat);
+        }
+    };
+
+    template<>
+    struct converter<bfloat16, float> {
+        static void run(bfloat16 const* const src, float* const dst, size_t const n, rounding const r, bool const sat)
+        {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+                __m128i const zero = _mm_setzero_si128();
+                _mm_storeu_ps(dst + i, _mm_castsi128_ps(_mm_unpacklo_epi16(zero, v)));
+                _mm_storeu_ps(dst + i + 4, _mm_castsi128_ps(_mm_unpackhi_epi16(zero, v)));
+            }
+            convert_scalar(src + i, dst + i, n - i, r, sat);
+        }
+    };
+#endif
+
+    // Element type of the view make_view() returns for Array.
+    template<class Array>
+    struct array_element {
+        typedef typename decltype(make_view(std::declval<Array const&>()))::value_type type;
+    };
+
+    template<class From, class To>
+    inline mutable_array_view<To> convert_into_impl(array_view<From> const& src, mutable_array_view<To> const& dest, rounding const r, bool const sat)
+    {
+        if (dest.size() < src.size()) {
+            throw std::invalid_argument("convert_into(): destination is too small");
+        }
+        converter<From, To>::run(src.data(), dest.data(), src.size(), r, sat);
+        return mutable_array_view<To>{dest.data(), src.size()};
+    }
+    // }}}
+} // namespace detail
+
+// bulk conversion {{{
+
+// Converts all elements of src into the beginning of dest and returns the
+// written part of dest.  dest must hold at least src.size() elements.
+template<class From, class To>
+mutable_array_view<To> convert_into(
+        array_view<From> const& src,
+        mutable_array_view<To> const& dest,
+        rounding const r = detail::default_rounding<From, To>())
+{
+    return detail::convert_into_impl(src, dest, r, false);
+}
+
+template<class From, class To>
+mutable_array_view<To> convert_into(
+        saturate_t,
+        array_view<From> const& src,
+        mutable_array_view<To> const& dest,
+        rounding const r = detail::default_rounding<From, To>())
+{
+    return detail::convert_into_impl(src, dest, r, true);
+}
+
+// Same as above for a vector or array as the source.
+template<
+    class Array,
+    class To,
+    class = typename std::enable_if<
+        is_array<Array>::value
+    >::type
+>
+mutable_array_view<To> convert_into(
+        Array const& src,
+        mutable_array_view<To> const& dest,
+        rounding const r = detail::default_rounding<typename detail::array_element<Array>::type, To>())
+{
+    return convert_into(make_view(src), dest, r);
+}
+
+template<
+    class Array,
+    class To,
+    class = typename std::enable_if<
+        is_array<Array>::value
+    >::type
+>
+mutable_array_view<To> convert_into(
+        saturate_t,
+        Array const& src,
+        mutable_array_view<To> const& dest,
+        rounding const r = detail::default_rounding<typename detail::array_element<Array>::type, To>())
+{
+    return convert_into(saturate, make_view(src), dest, r);
+}
+// }}}
+
+// converted_array_view {{{
+
+// Read only view of an array_view<From> whose elements are converted to To
+// on access.
+template<class To, class From>
+class converted_array_view {
+public:
+    /*
+     * types
+     */
+    typedef To value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    class const_iterator {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef To value_type;
+        typedef ptrdiff_t difference_type;
+        typedef To const* pointer;
+        typedef To reference;
+
+        const_iterator() noexcept
+            : ptr_(nullptr), round_(rounding::to_nearest_even), saturate_(false)
+        {}
+
+        const_iterator(From const* const p, rounding const r, bool const sat) noexcept
+            : ptr_(p), round_(r), saturate_(sat)
+        {}
+
+        reference operator*() const noexcept
+        {
+            return detail::convert_one<From, To>::apply(*ptr_, round_, saturate_);
+        }
+        reference operator[](difference_type const n) const noexcept
+        {
+            return detail::convert_one<From, To>::apply(ptr_[n], round_, saturate_);
+        }
+
+        const_iterator& operator++() noexcept { ++ptr_; return *this; }
+        const_iterator& operator--() noexcept { --ptr_; return *this; }
+        const_iterator operator++(int) noexcept { auto t = *this; ++ptr_; return t; }
+        const_iterator operator--(int) noexcept { auto t = *this; --ptr_; return t; }
+        const_iterator& operator+=(difference_type const n) noexcept { ptr_ += n; return *this; }
+        const_iterator& operator-=(difference_type const n) noexcept { ptr_ -= n; return *this; }
+        const_iterator operator+(difference_type const n) const noexcept { return {ptr_ + n, round_, saturate_}; }
+        const_iterator operator-(difference_type const n) const noexcept { return {ptr_ - n, round_, saturate_}; }
+        friend const_iterator operator+(difference_type const n, const_iterator const& i) noexcept { return i + n; }
+        difference_type operator-(const_iterator const& rhs) const noexcept { return ptr_ - rhs.ptr_; }
+
+        bool operator==(const_iterator const& rhs) const noexcept { return ptr_ == rhs.ptr_; }
+        bool operator!=(const_iterator const& rhs) const noexcept { return ptr_ != rhs.ptr_; }
+        bool operator<(const_iterator const& rhs) const noexcept { return ptr_ < rhs.ptr_; }
+        bool operator>(const_iterator const& rhs) const noexcept { return ptr_ > rhs.ptr_; }
+        bool operator<=(const_iterator const& rhs) const noexcept { return ptr_ <= rhs.ptr_; }
+        bool operator>=(const_iterator const& rhs) const noexcept { return ptr_ >= rhs.ptr_; }
+
+    private:
+        From const* ptr_;
+        rounding round_;
+        bool saturate_;
+    };
+    typedef const_iterator iterator;
+
+    /*
+     * ctors and assign operators
+     */
+    explicit converted_array_view(array_view<From> const& src, rounding const r = detail::default_rounding<From, To>(), bool const sat = false) noexcept
+        : src_(src), round_(r), saturate_(sat)
+    {}
+
+    converted_array_view& operator=(converted_array_view const&) = delete;
+
+    /*
+     * iterator interfaces
+     */
+    const_iterator begin() const noexcept
+    {
+        return {src_.begin(), round_, saturate_};
+    }
+    const_iterator end() const noexcept
+    {
+        return {src_.end(), round_, saturate_};
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    /*
+     * access
+     */
+    size_type size() const noexcept
+    {
+        return src_.size();
+    }
+    size_type length() const noexcept
+    {
+        return size();
+    }
+    bool empty() const noexcept
+    {
+        return src_.empty();
+    }
+    value_type operator[](size_type const n) const noexcept
+    {
+        return detail::convert_one<From, To>::apply(src_[n], round_, saturate_);
+    }
+    value_type at(size_type const n) const
+    {
+        return detail::convert_one<From, To>::apply(src_.at(n), round_, saturate_);
+    }
+    array_view<From> const& source() const noexcept
+    {
+        return src_;
+    }
+
+    /*
+     * others
+     */
+    mutable_array_view<To> convert_into(mutable_array_view<To> const& dest) const
+    {
+        return detail::convert_into_impl(src_, dest, round_, saturate_);
+    }
+
+    template<class Allocator = std::allocator<To>>
+    auto to_vector(Allocator const& alloc = Allocator{}) const
+        -> std::vector<To, Allocator>
+    {
+        std::vector<To, Allocator> v(size(), To{}, alloc);
+        convert_into(mutable_array_view<To>{v.data(), v.size()});
+        return v;
+    }
+
+private:
+    array_view<From> const src_;
+    rounding const round_;
+    bool const saturate_;
+};
+// }}}
+
+// helpers to construct view {{{
+template<class To, class From>
+inline
+converted_array_view<To, From> make_converted_view(array_view<From> const& v, rounding const r = detail::default_rounding<From, To>())
+{
+    return converted_array_view<To, From>{v, r};
+}
+
+template<class To, class From>
+inline
+converted_array_view<To, From> make_converted_view(saturate_t, array_view<From> const& v, rounding const r = detail::default_rounding<From, To>())
+{
+    return converted_array_view<To, From>{v, r, true};
+}
+
+template<
+    class To,
+    class Array,
+    class = typename std::enable_if<
+        is_array<Array>::value
+    >::type
+>
+inline
+auto make_converted_view(Array const& a, rounding const r = detail::default_rounding<typename detail::array_element<Array>::type, To>())
+    -> converted_array_view<To, typename detail::array_element<Array>::type>
+{
+    return make_converted_view<To>(make_view(a), r);
+}
+
+template<
+    class To,
+    class Array,
+    class = typename std::enable_if<
+        is_array<Array>::value
+    >::type
+>
+inline
+auto make_converted_view(saturate_t, Array const& a, rounding const r = detail::default_rounding<typename detail::array_element<Array>::type, To>())
+    -> converted_array_view<To, typename detail::array_element<Array>::type>
+{
+    return make_converted_view<To>(saturate, make_view(a), r);
+}
+// }}}
+
+} // namespace arv
+
+#endif    // ARV_ARRAY_VIEW_CONVERT_HPP_INCLUDED
@@ -0,0 +1,371 @@
+#if !defined ARV_ARRAY_VIEW_SET_HPP_INCLUDED
+#define      ARV_ARRAY_VIEW_SET_HPP_INCLUDED
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "array_view.hpp"
+
+// Set operations on sorted views.
+//
+// All inputs must be strictly increasing, i.e. sorted and free of
+// duplicates.  Results are written to a caller-provided buffer and the
+// written part of it is returned; nothing is allocated.  The strategy is
+// chosen from the input sizes: when one input is much smaller than the
+// other, the larger one is searched with exponential (galloping) search,
+// otherwise both are merged, for 32 bit integers with SSE2 if available.
+
+namespace arv {
+
+namespace detail {
+    template<class T>
+    struct identity {
+        typedef T type;
+    };
+
+    // Inputs whose sizes differ at least by this factor are galloped.
+    static constexpr size_t gallop_ratio = 32;
+
+    inline void check_output(size_t const required, size_t const available, char const* const what)
+    {
+        if (available < required) {
+            throw std::invalid_argument(what);
+        }
+    }
+
+    // First position in [first, last) which is not less than value.
+    template<class T>
+    inline T const* gallop(T const* first, T const* const last, T const& value)
+    {
+        size_t step = 1;
+        while (first + step < last && first[step] < value) {
+            first += step;
+            step *= 2;
+        }
+        return std::lower_bound(first, std::min(first + step + 1, last), value);
+    }
+
+    template<class T>
+    struct write_sink {
+        T* out;
+        size_t n;
+        void operator()(T const& t)
+        {
+            out[n++] = t;
+        }
+    };
+
+    template<class T>
+    struct count_sink {
+        size_t n;
+        void operator()(T const&)
+        {
+            ++n;
+        }
+    };
+
+    // Every element of small is searched in large.
+    template<class T, class Sink>
+    inline void intersect_gallop(T const* a, T const* const a_end, T const* b, T const* const b_end, Sink &sink)
+    {
+        for (; a != a_end; ++a) {
+            b = gallop(b, b_end, *a);
+            if (b == b_end) {
+                break;
+            }
+            if (*b == *a) {
+                sink(*a);
+                ++b;
+            }
+        }
+    }
+
+    template<class T, class Sink>
+    inline void intersect_merge(T const* a, T const* const a_end, T const* b, T const* const b_end, Sink &sink)
+    {
+        while (a != a_end && b != b_end) {
+            if (*a < *b) {
+                ++a;
+            } else if (*b < *a) {
+                ++b;
+            } else {
+                sink(*a);
+                ++a;
+                ++b;
+            }
+        }
+    }
+
+#if defined __SSE2__
+    template<class T>
+    struct is_simd_intersectable {
+        static bool const value = std::is_integral<T>::value && sizeof(T) == 4;
+    };
+
+    // Compares blocks of four elements of a against all rotations of blocks of
+    // four elements of b.  The block of a is only loaded when a advances, so
+    // the sink may overwrite the already consumed part of a.
+    template<class T, class Sink>
+    inline void intersect_simd(T const* a, T const* const a_end, T const* b, T const* const b_end, Sink &sink)
+    {
+        if (a_end - a >= 4 && b_end - b >= 4) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<__m128i const*>(a));
+            T a_block[4] = {a[0], a[1], a[2], a[3]};
+            while (true) {
+                __m128i const vb = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b));
+                __m128i m = _mm_cmpeq_epi32(va, vb);
+                m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+                m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+                m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+                int mask = _mm_movemask_ps(_mm_castsi128_ps(m));
+                while (mask != 0) {
+                    int const lane = __builtin_ctz(static_cast<unsigned>(mask));
+                    sink(a_block[lane]);
+                    mask &= mask - 1;
+                }
+
+                T const a_max = a_block[3];
+                T const b_max = b[3];
+                if (!(b_max < a_max)) {
+                    a += 4;
+                    if (a_end - a < 4) {
+                        // Elements of this b block not greater than a_max were compared already.
+                        b += (a_max < b_max) ? 0 : 4;
+                        break;
+                    }
+                    va = _mm_loadu_si128(reinterpret_cast<__m128i const*>(a));
+                    std::copy(a, a + 4, a_block);
+                }
+                if (!(a_max < b_max)) {
+                    b += 4;
+                    if (b_end - b < 4) {
+                        break;
+                    }
+                }
+            }
+        }
+        intersect_merge(a, a_end, b, b_end, sink);
+    }
+#endif
+
+    // Dispatches on the sizes of a and b.  Results are emitted in order from
+    // a, which may alias the output as long as a is not the larger input.
+    template<class T, class Sink>
+    inline void intersect_impl(array_view<T> const& a, array_view<T> const& b, Sink &sink)
+    {
+        if (a.empty() || b.empty()) {
+            return;
+        }
+        if (b.size() < a.size()) {
+            if (a.size() / b.size() >= gallop_ratio) {
+                intersect_gallop(b.begin(), b.end(), a.begin(), a.end(), sink);
+                return;
+            }
+        } else if (b.size() / a.size() >= gallop_ratio) {
+            intersect_gallop(a.begin(), a.end(), b.begin(), b.end(), sink);
+            return;
+        }
+#if defined __SSE2__
+        if (is_simd_intersectable<T>::value) {
+            intersect_simd(a.begin(), a.end(), b.begin(), b.end(), sink);
+            return;
+        }
+#endif
+        intersect_merge(a.begin(), a.end(), b.begin(), b.end(), sink);
+    }
+} // namespace detail
+
+// intersection {{{
+
+// Writes the elements contained in both a and b to out.
+// out must hold at least min(a.size(), b.size()) elements.
+template<class T>
+mutable_array_view<T> intersect(
+        typename detail::identity<array_view<T>>::type const& a,
+        typename detail::identity<array_view<T>>::type const& b,
+        mutable_array_view<T> const& out)
+{
+    detail::check_output(std::min(a.size(), b.size()), out.size(), "intersect(): output buffer is too small");
+    detail::write_sink<T> sink{out.data(), 0};
+    detail::intersect_impl(a, b, sink);
+    return out.slice_before(sink.n);
+}
+
+// Counts the elements contained in both a and b.
+template<class T>
+size_t intersect_count(array_view<T> const& a, typename detail::identity<array_view<T>>::type const& b)
+{
+    detail::count_sink<T> sink{0};
+    detail::intersect_impl(a, b, sink);
+    return sink.n;
+}
+
+// Same as above for a vector or array as the first input, so that neither
+// input has to be converted explicitly.
+template<
+    class Array,
+    class = typename std::enable_if<
+        detail::is_array_class<Array>::value
+    >::type
+>
+size_t intersect_count(Array const& a, typename detail::identity<array_view<typename Array::value_type>>::type const& b)
+{
+    return intersect_count(array_view<typename Array::value_type>{a}, b);
+}
+
+// Writes the elements contained in all lists to out.  Lists are intersected
+// pairwise from the smallest to the largest, the intermediate results are
+// kept in out.  out must hold at least as many elements as the smallest list.
+template<class T>
+mutable_array_view<T> intersect(array_view<array_view<T>> const& lists, mutable_array_view<T> const& out)
+{
+    if (lists.empty()) {
+        return mutable_array_view<T>{out.data(), 0};
+    }
+
+    // Visits the lists ordered by (size, position) without sorting them.
+    auto const next = [&lists](array_view<T> const* const prev) {
+        array_view<T> const* best = nullptr;
+        for (auto const& l : lists) {
+            bool const after_prev = prev == nullptr
+                || l.size() > prev->size()
+                || (l.size() == prev->size() && &l > prev);
+            bool const before_best = best == nullptr
+                || l.size() < best->size();
+            if (after_prev && before_best) {
+                best = &l;
+            }
+        }
+        return best;
+    };
+
+    auto const* const smallest = next(nullptr);
+    detail::check_output(smallest->size(), out.size(), "intersect(): output buffer is too small");
+    if (lists.size() == 1) {
+        std::copy(smallest->begin(), smallest->end(), out.begin());
+        return out.slice_before(smallest->size());
+    }
+
+    auto const* const second = next(smallest);
+    detail::write_sink<T> sink{out.data(), 0};
+    detail::intersect_impl(*smallest, *second, sink);
+
+    // The intermediate result is never larger than the following lists,
+    // so it is always the first input and may be overwritten in place.
+    for (auto const* l = next(second); l != nullptr && sink.n != 0; l = next(l)) {
+        array_view<T> const result{out.data(), sink.n};
+        sink.n = 0;
+        detail::intersect_impl(result, *l, sink);
+    }
+    return out.slice_before(sink.n);
+}
+// }}}
+
+// union {{{
+
+// Writes the elements contained in a or b to out.
+// out must hold at least a.size() + b.size() elements.
+template<class T>
+mutable_array_view<T> unite(
+        typename detail::identity<array_view<T>>::type const& a,
+        typename detail::identity<array_view<T>>::type const& b,
+        mutable_array_view<T> const& out)
+{
+    detail::check_output(a.size() + b.size(), out.size(), "unite(): output buffer is too small");
+
+    array_view<T> const& small = a.size() < b.size() ? a : b;
+    array_view<T> const& large = a.size() < b.size() ? b : a;
+    T* o = out.data();
+
+    if (!small.empty() && large.size() / small.size() >= detail::gallop_ratio) {
+        // Copy the runs of large between the elements of small in bulk.
+        auto l = large.begin();
+        for (auto const& s : small) {
+            auto const pos = detail::gallop(l, large.end(), s);
+            o = std::copy(l, pos, o);
+            *o++ = s;
+            l = (pos != large.end() && *pos == s) ? pos + 1 : pos;
+        }
+        o = std::copy(l, large.end(), o);
+    } else {
+        auto i = a.begin();
+        auto j = b.begin();
+        while (i != a.end() && j != b.end()) {
+            if (*i < *j) {
+                *o++ = *i++;
+            } else if (*j < *i) {
+                *o++ = *j++;
+            } else {
+                *o++ = *i++;
+                ++j;
+            }
+        }
+        o = std::copy(i, a.end(), o);
+        o = std::copy(j, b.end(), o);
+    }
+    return out.slice_before(static_cast<size_t>(o - out.data()));
+}
+// }}}
+
+// difference {{{
+
+// Writes the elements contained in a but not in b to out.
+// out must hold at least a.size() elements.
+template<class T>
+mutable_array_view<T> difference(
+        typename detail::identity<array_view<T>>::type const& a,
+        typename detail::identity<array_view<T>>::type const& b,
+        mutable_array_view<T> const& out)
+{
+    detail::check_output(a.size(), out.size(), "difference(): output buffer is too small");
+
+    T* o = out.data();
+    if (a.empty() || b.empty()) {
+        o = std::copy(a.begin(), a.end(), o);
+    } else if (b.size() / a.size() >= detail::gallop_ratio) {
+        // Search every element of a in b.
+        auto j = b.begin();
+        for (auto const& x : a) {
+            j = detail::gallop(j, b.end(), x);
+            if (j == b.end() || x < *j) {
+                *o++ = x;
+            } else {
+                ++j;
+            }
+        }
+    } else if (a.size() / b.size() >= detail::gallop_ratio) {
+        // Copy the runs of a between the elements of b in bulk.
+        auto i = a.begin();
+        for (auto const& y : b) {
+            auto const pos = detail::gallop(i, a.end(), y);
+            o = std::copy(i, pos, o);
+            i = (pos != a.end() && *pos == y) ? pos + 1 : pos;
+        }
+        o = std::copy(i, a.end(), o);
+    } else {
+        auto i = a.begin();
+        auto j = b.begin();
+        while (i != a.end() && j != b.end()) {
+            if (*i < *j) {
+                *o++ = *i++;
+            } else if (*j < *i) {
+                ++j;
+            } else {
+                ++i;
+                ++j;
+            }
+        }
+        o = std::copy(i, a.end(), o);
+    }
+    return out.slice_before(static_cast<size_t>(o - out.data()));
+}
+// }}}
+
+} // namespace arv
+
+#endif    // ARV_ARRAY_VIEW_SET_HPP_INCLUDED
@@ -0,0 +1,339 @@
+#if !defined ARV_ARRAY_VIEW_STREAM_HPP_INCLUDED
+#define      ARV_ARRAY_VIEW_STREAM_HPP_INCLUDED
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "array_view.hpp"
+
+namespace arv {
+
+// stream_reader {{{
+
+// Reads records of type T from a file descriptor on a background thread and
+// hands them out as array_views, so that reading and processing overlap.
+//
+// The reader owns buffer_count page-aligned buffers of buffer_bytes each.
+// A buffer is filled until it is full or the input ends and then delivered
+// as a batch of the whole records in it.  A partial record at the end of a
+// buffer is carried over to the beginning of the next one.  A buffer is
+// reused once its batch is released, so at most buffer_count batches can be
+// held at the same time and the reader must outlive all of them.
+//
+// If offset is not negative, the input is read with pread() from that
+// offset and the file position of fd is left untouched, otherwise it is
+// read with read().  The file descriptor is not closed.
+//
+// The background thread waits for input with poll() on fd and on a pipe
+// of its own, so that destroying the reader does not block until the
+// writer of a pipe or socket sends more data or closes its end.
+template<class T>
+class stream_reader {
+    static_assert(
+        std::is_standard_layout<T>::value && std::is_trivially_destructible<T>::value,
+        "stream_reader requires plain data records."
+    );
+public:
+    static constexpr size_t buffer_alignment = 4096;
+
+    class batch {
+    public:
+        batch() noexcept
+            : reader_(nullptr), index_(0), data_(nullptr), size_(0)
+        {}
+
+        batch(batch && other) noexcept
+            : reader_(other.reader_), index_(other.index_), data_(other.data_), size_(other.size_)
+        {
+            other.reader_ = nullptr;
+        }
+
+        batch& operator=(batch && other) noexcept
+        {
+            if (this != &other) {
+                release();
+                reader_ = other.reader_;
+                index_ = other.index_;
+                data_ = other.data_;
+                size_ = other.size_;
+                other.reader_ = nullptr;
+            }
+            return *this;
+        }
+
+        batch(batch const&) = delete;
+        batch& operator=(batch const&) = delete;
+
+        ~batch()
+        {
+            release();
+        }
+
+        array_view<T> view() const noexcept
+        {
+            return {data_, size_};
+        }
+
+        /*implicit*/ operator array_view<T>() const noexcept
+        {
+            return view();
+        }
+
+        size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        // False once the input is exhausted.
+        explicit operator bool() const noexcept
+        {
+            return !empty();
+        }
+
+        // Hands the buffer back to the reader, the view must not be used afterwards.
+        void release() noexcept
+        {
+            if (reader_ != nullptr) {
+                reader_->recycle(index_);
+                reader_ = nullptr;
+            }
+        }
+
+    private:
+        friend class stream_reader;
+
+        batch(stream_reader* const reader, size_t const index, T const* const data, size_t const size) noexcept
+            : reader_(reader), index_(index), data_(data), size_(size)
+        {}
+
+        stream_reader* reader_;
+        size_t index_;
+        T const* data_;
+        size_t size_;
+    };
+
+    explicit stream_reader(int const fd, size_t const buffer_bytes = size_t{1} << 20, size_t const buffer_count = 2, std::int64_t const offset = -1)
+        : fd_(fd), offset_(offset), buffer_bytes_(buffer_bytes), wakeup_{-1, -1}, stop_(false), done_(false)
+    {
+        if (buffer_bytes < sizeof(T)) {
+            throw std::invalid_argument("stream_reader: buffers must hold at least one record");
+        }
+        if (buffer_count == 0) {
+            throw std::invalid_argument("stream_reader: at least one buffer is required");
+        }
+        for (size_t i = 0; i < buffer_count; ++i) {
+            void* p = nullptr;
+            if (::posix_memalign(&p, buffer_alignment, buffer_bytes) != 0) {
+                throw std::bad_alloc();
+            }
+            buffers_.emplace_back(static_cast<char*>(p), &std::free);
+            free_.push_back(i);
+        }
+        if (::pipe(wakeup_) != 0) {
+            throw std::system_error(errno, std::generic_category(), "stream_reader: pipe failed");
+        }
+        for (int const w : wakeup_) {
+            ::fcntl(w, F_SETFD, FD_CLOEXEC);
+        }
+        try {
+            worker_ = std::thread(&stream_reader::fill_buffers, this);
+        } catch (...) {
+            close_wakeup();
+            throw;
+        }
+    }
+
+    stream_reader(stream_reader const&) = delete;
+    stream_reader& operator=(stream_reader const&) = delete;
+
+    // Wakes the background thread if it is waiting for input and joins it.
+    // A read which already started is not interrupted, but it only starts
+    // once poll() reported data, the end of the input or an error.
+    ~stream_reader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        changed_.notify_all();
+        char const c = 0;
+        while (::write(wakeup_[1], &c, 1) < 0 && errno == EINTR) {
+        }
+        worker_.join();
+        close_wakeup();
+    }
+
+    // Blocks until the next batch is available.  Returns an empty batch at
+    // the end of the input and rethrows errors of the background thread.
+    batch next()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this]{ return !filled_.empty() || done_; });
+        if (filled_.empty()) {
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+            return batch{};
+        }
+        auto const f = filled_.front();
+        filled_.pop_front();
+        return batch{this, f.index, reinterpret_cast<T const*>(buffers_[f.index].get()), f.records};
+    }
+
+private:
+    struct filled_buffer {
+        size_t index;
+        size_t records;
+    };
+
+    void recycle(size_t const index)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(index);
+        }
+        changed_.notify_all();
+    }
+
+    // Blocks until fd can be read without blocking.  Returns false if the
+    // reader is being destroyed instead.
+    bool wait_readable()
+    {
+        pollfd fds[2] = {{fd_, POLLIN, 0}, {wakeup_[0], POLLIN, 0}};
+        while (::poll(fds, 2, -1) < 0) {
+            if (errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(), "stream_reader: poll failed");
+            }
+        }
+        // POLLHUP and POLLERR are left to read() to report.
+        return fds[1].revents == 0;
+    }
+
+    // Returns the number of bytes read, 0 at the end of the input.
+    size_t read_some(char* const dst, size_t const n)
+    {
+        while (true) {
+            ssize_t const r = offset_ >= 0
+                ? ::pread(fd_, dst, n, static_cast<off_t>(offset_))
+                : ::read(fd_, dst, n);
+            if (r >= 0) {
+                if (offset_ >= 0) {
+                    offset_ += r;
+                }
+                return static_cast<size_t>(r);
+            }
+            if (errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(), "stream_reader: read failed");
+            }
+        }
+    }
+
+    void fill_buffers()
+    {
+        try {
+            char carry[sizeof(T)];
+            size_t carry_bytes = 0;
+            bool eof = false;
+            while (!eof) {
+                size_t index;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    changed_.wait(lock, [this]{ return !free_.empty() || stop_; });
+                    if (stop_) {
+                        break;
+                    }
+                    index = free_.front();
+                    free_.pop_front();
+                }
+
+                char* const buf = buffers_[index].get();
+                std::memcpy(buf, carry, carry_bytes);
+                size_t filled = carry_bytes;
+                while (filled < buffer_bytes_ && wait_readable()) {
+                    size_t const n = read_some(buf + filled, buffer_bytes_ - filled);
+                    if (n == 0) {
+                        eof = true;
+                        break;
+                    }
+                    filled += n;
+                }
+
+                size_t const records = filled / sizeof(T);
+                carry_bytes = filled % sizeof(T);
+                std::memcpy(carry, buf + records * sizeof(T), carry_bytes);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (records != 0) {
+                        filled_.push_back(filled_buffer{index, records});
+                    } else {
+                        free_.push_back(index);
+                    }
+                }
+                changed_.notify_all();
+
+                if (eof && carry_bytes != 0) {
+                    throw std::runtime_error("stream_reader: input ends with a partial record");
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_ = true;
+        }
+        changed_.notify_all();
+    }
+
+    void close_wakeup() noexcept
+    {
+        ::close(wakeup_[0]);
+        ::close(wakeup_[1]);
+    }
+
+    int const fd_;
+    std::int64_t offset_;
+    size_t const buffer_bytes_;
+    std::vector<std::unique_ptr<char, void(*)(void*)>> buffers_;
+    int wakeup_[2];
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<size_t> free_;
+    std::deque<filled_buffer> filled_;
+    bool stop_;
+    bool done_;
+    std::exception_ptr error_;
+    std::thread worker_;
+};
+// }}}
+
+} // namespace arv
+
+#endif    // ARV_ARRAY_VIEW_STREAM_HPP_INCLUDED
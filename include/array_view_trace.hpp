@@ -0,0 +1,654 @@
+#if !defined ARV_ARRAY_VIEW_TRACE_HPP_INCLUDED
+#define      ARV_ARRAY_VIEW_TRACE_HPP_INCLUDED
+
+#include "array_view.hpp"
+
+// traced_array_view is a drop-in replacement of array_view which records how
+// a labeled view is accessed.  Recording is only compiled in when
+// ARV_ENABLE_TRACE is defined, otherwise traced_array_view is array_view
+// with an ignored label.  Passing a traced view to a function taking
+// array_view converts it to a plain view, accesses through it are not recorded.
+//
+// ARV_ENABLE_TRACE changes the definition of traced_array_view, so it must
+// be defined for the whole program (e.g. -DARV_ENABLE_TRACE for every
+// translation unit), never by a #define in a single source file.
+//
+// When enabled, each thread counts into its own counters which are merged
+// when the thread exits.  At program exit all counters are dumped as JSON to
+// the file named by the environment variable ARV_TRACE_FILE, or to stderr.
+
+#if defined ARV_ENABLE_TRACE
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#if !defined ARV_TRACE_CACHE_LINE_SIZE
+#define ARV_TRACE_CACHE_LINE_SIZE 64
+#endif
+
+namespace arv {
+
+namespace trace {
+
+// Strides are counted in elements.  Bucket 0 counts repeated accesses to the
+// same element, bucket k (k >= 1) counts strides s with 2^(k-1) <= |s| < 2^k.
+// In the JSON output buckets are keyed by their signed lower bound.
+static constexpr size_t stride_buckets = 65;
+
+// HyperLogLog estimate of the number of distinct values added, with fixed
+// memory and a standard error of about 3%.
+class distinct_counter {
+public:
+    static constexpr size_t precision = 10;
+    static constexpr size_t registers = size_t{1} << precision;
+
+    void add(std::uint64_t x) noexcept
+    {
+        // splitmix64 finalizer
+        x += 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        x ^= x >> 31;
+
+        size_t const index = static_cast<size_t>(x >> (64 - precision));
+        std::uint64_t const rest = x << precision;
+        std::uint8_t const rank = rest == 0
+            ? static_cast<std::uint8_t>(64 - precision + 1)
+            : static_cast<std::uint8_t>(__builtin_clzll(rest) + 1);
+        if (rank > registers_[index]) {
+            registers_[index] = rank;
+        }
+    }
+
+    void merge(distinct_counter const& other) noexcept
+    {
+        for (size_t i = 0; i < registers; ++i) {
+            if (other.registers_[i] > registers_[i]) {
+                registers_[i] = other.registers_[i];
+            }
+        }
+    }
+
+    std::uint64_t estimate() const noexcept
+    {
+        double const m = static_cast<double>(registers);
+        double sum = 0.0;
+        size_t zeros = 0;
+        for (auto const r : registers_) {
+            sum += std::ldexp(1.0, -static_cast<int>(r));
+            zeros += r == 0;
+        }
+        double e = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+        if (e <= 2.5 * m && zeros != 0) {
+            // Linear counting is more accurate for small counts.
+            e = m * std::log(m / static_cast<double>(zeros));
+        }
+        return static_cast<std::uint64_t>(e + 0.5);
+    }
+
+private:
+    std::array<std::uint8_t, registers> registers_ = {{}};
+};
+
+struct view_stats {
+    std::uint64_t instances = 0;
+    std::uint64_t accesses = 0;
+    std::uint64_t slices = 0;
+    std::uint64_t to_vector_bytes = 0;
+    std::uint64_t forward_strides[stride_buckets] = {};
+    std::uint64_t backward_strides[stride_buckets] = {};
+    // Approximate, see distinct_counter.
+    distinct_counter cache_lines;
+
+    void merge(view_stats const& other)
+    {
+        instances += other.instances;
+        accesses += other.accesses;
+        slices += other.slices;
+        to_vector_bytes += other.to_vector_bytes;
+        for (size_t i = 0; i < stride_buckets; ++i) {
+            forward_strides[i] += other.forward_strides[i];
+            backward_strides[i] += other.backward_strides[i];
+        }
+        cache_lines.merge(other.cache_lines);
+    }
+};
+
+namespace detail {
+    inline size_t stride_bucket(std::uint64_t s) noexcept
+    {
+        size_t k = 0;
+        while (s != 0) {
+            s >>= 1;
+            ++k;
+        }
+        return k;
+    }
+
+    inline void write_json_string(std::ostream &ost, std::string const& s)
+    {
+        ost << '"';
+        for (char const c : s) {
+            if (c == '"' || c == '\\') {
+                ost << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                ost << ' ';
+            } else {
+                ost << c;
+            }
+        }
+        ost << '"';
+    }
+
+    inline void write_json_strides(std::ostream &ost, char const sign, std::uint64_t const (&buckets)[stride_buckets], bool &first)
+    {
+        for (size_t k = 1; k < stride_buckets; ++k) {
+            if (buckets[k] == 0) {
+                continue;
+            }
+            ost << (first ? "" : ", ") << '"' << sign << (std::uint64_t{1} << (k - 1)) << "\": " << buckets[k];
+            first = false;
+        }
+    }
+
+    class registry {
+    public:
+        static registry& instance()
+        {
+            static registry r;
+            return r;
+        }
+
+        void merge(std::map<std::string, view_stats> const& local)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto const& kv : local) {
+                stats_[kv.first].merge(kv.second);
+            }
+        }
+
+        view_stats stats(std::string const& label)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto const itr = stats_.find(label);
+            return itr == stats_.end() ? view_stats{} : itr->second;
+        }
+
+        void dump(std::ostream &ost)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ost << "{\"cache_line_size\": " << ARV_TRACE_CACHE_LINE_SIZE << ", \"views\": [";
+            bool first_view = true;
+            for (auto const& kv : stats_) {
+                auto const& s = kv.second;
+                ost << (first_view ? "\n" : ",\n") << "  {\"label\": ";
+                write_json_string(ost, kv.first);
+                ost << ", \"instances\": " << s.instances
+                    << ", \"accesses\": " << s.accesses
+                    << ", \"distinct_cache_lines_estimate\": " << s.cache_lines.estimate()
+                    << ", \"slices\": " << s.slices
+                    << ", \"to_vector_bytes\": " << s.to_vector_bytes
+                    << ", \"strides\": {";
+                bool first = true;
+                if (s.forward_strides[0] != 0) {
+                    ost << "\"0\": " << s.forward_strides[0];
+                    first = false;
+                }
+                write_json_strides(ost, '+', s.forward_strides, first);
+                write_json_strides(ost, '-', s.backward_strides, first);
+                ost << "}}";
+                first_view = false;
+            }
+            ost << (first_view ? "" : "\n") << "]}\n";
+        }
+
+        ~registry()
+        {
+            char const* const path = std::getenv("ARV_TRACE_FILE");
+            if (path != nullptr && *path != '\0') {
+                std::ofstream ofs(path);
+                dump(ofs);
+            } else {
+                dump(std::cerr);
+            }
+        }
+
+    private:
+        registry() = default;
+
+        std::mutex mutex_;
+        std::map<std::string, view_stats> stats_;
+    };
+
+    // Counters of one label in one thread.
+    struct local_counters {
+        view_stats stats;
+        std::uintptr_t last_addr = 0;
+        bool has_last = false;
+    };
+
+    class thread_state {
+    public:
+        thread_state()
+            : id_(next_id())
+        {
+            // Construct the registry first so that it outlives this object.
+            registry::instance();
+        }
+
+        ~thread_state()
+        {
+            flush();
+        }
+
+        static thread_state& current()
+        {
+            static thread_local thread_state s;
+            return s;
+        }
+
+        std::uint64_t id() const noexcept
+        {
+            return id_;
+        }
+
+        // Called once per view and thread, the probes cache the result.
+        local_counters* lookup(char const* const label)
+        {
+            return &local_[label];
+        }
+
+        static void record(local_counters &c, std::uintptr_t const addr, size_t const elem_size)
+        {
+            ++c.stats.accesses;
+
+            std::uintptr_t const line = addr / ARV_TRACE_CACHE_LINE_SIZE;
+            if (!c.has_last || line != c.last_addr / ARV_TRACE_CACHE_LINE_SIZE) {
+                c.stats.cache_lines.add(line);
+            }
+
+            if (c.has_last) {
+                if (addr >= c.last_addr) {
+                    ++c.stats.forward_strides[stride_bucket((addr - c.last_addr) / elem_size)];
+                } else {
+                    ++c.stats.backward_strides[stride_bucket((c.last_addr - addr) / elem_size)];
+                }
+            }
+            c.last_addr = addr;
+            c.has_last = true;
+        }
+
+        void flush()
+        {
+            std::map<std::string, view_stats> merged;
+            for (auto& kv : local_) {
+                merged[kv.first].merge(kv.second.stats);
+                kv.second = local_counters{};
+            }
+            registry::instance().merge(merged);
+        }
+
+    private:
+        static std::uint64_t next_id()
+        {
+            static std::mutex m;
+            static std::uint64_t id = 0;
+            std::lock_guard<std::mutex> lock(m);
+            return ++id;
+        }
+
+        std::uint64_t const id_;
+        // Keyed by a copy of the label, the counters are flushed at thread
+        // exit when the label passed to a view may be gone.
+        std::map<std::string, local_counters> local_;
+    };
+
+    // Handle of a view or iterator to the counters of its label in the calling thread.
+    class probe {
+    public:
+        explicit probe(char const* const label)
+            : label_(label), owner_(0), counters_(nullptr)
+        {}
+
+        char const* label() const noexcept
+        {
+            return label_;
+        }
+
+        view_stats& stats() const
+        {
+            return counters().stats;
+        }
+
+        template<class T>
+        void access(T const* const p) const
+        {
+            thread_state::record(counters(), reinterpret_cast<std::uintptr_t>(p), sizeof(T));
+        }
+
+    private:
+        // Views may be handed to other threads, so the cached counters are
+        // only used while the calling thread is the one which looked them up.
+        local_counters& counters() const
+        {
+            auto& state = thread_state::current();
+            if (state.id() != owner_) {
+                owner_ = state.id();
+                counters_ = state.lookup(label_);
+            }
+            return *counters_;
+        }
+
+        char const* label_;
+        mutable std::uint64_t owner_;
+        mutable local_counters* counters_;
+    };
+} // namespace detail
+
+// Merges the counters of the calling thread and returns the totals of a label.
+inline view_stats stats(std::string const& label)
+{
+    detail::thread_state::current().flush();
+    return detail::registry::instance().stats(label);
+}
+
+// Merges the counters of the calling thread and writes all totals as JSON.
+inline void dump(std::ostream &ost)
+{
+    detail::thread_state::current().flush();
+    detail::registry::instance().dump(ost);
+}
+
+} // namespace trace
+
+// traced_iterator {{{
+template<class T>
+class traced_iterator {
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef ptrdiff_t difference_type;
+    typedef T const* pointer;
+    typedef T const& reference;
+
+    traced_iterator() noexcept
+        : ptr_(nullptr), probe_(nullptr)
+    {}
+
+    traced_iterator(T const* const p, trace::detail::probe const& probe) noexcept
+        : ptr_(p), probe_(probe)
+    {}
+
+    reference operator*() const
+    {
+        probe_.access(ptr_);
+        return *ptr_;
+    }
+    pointer operator->() const
+    {
+        probe_.access(ptr_);
+        return ptr_;
+    }
+    reference operator[](difference_type const n) const
+    {
+        probe_.access(ptr_ + n);
+        return ptr_[n];
+    }
+
+    traced_iterator& operator++() noexcept { ++ptr_; return *this; }
+    traced_iterator& operator--() noexcept { --ptr_; return *this; }
+    traced_iterator operator++(int) noexcept { auto t = *this; ++ptr_; return t; }
+    traced_iterator operator--(int) noexcept { auto t = *this; --ptr_; return t; }
+    traced_iterator& operator+=(difference_type const n) noexcept { ptr_ += n; return *this; }
+    traced_iterator& operator-=(difference_type const n) noexcept { ptr_ -= n; return *this; }
+    traced_iterator operator+(difference_type const n) const noexcept { return {ptr_ + n, probe_}; }
+    traced_iterator operator-(difference_type const n) const noexcept { return {ptr_ - n, probe_}; }
+    friend traced_iterator operator+(difference_type const n, traced_iterator const& i) noexcept { return i + n; }
+    difference_type operator-(traced_iterator const& rhs) const noexcept { return ptr_ - rhs.ptr_; }
+
+    bool operator==(traced_iterator const& rhs) const noexcept { return ptr_ == rhs.ptr_; }
+    bool operator!=(traced_iterator const& rhs) const noexcept { return ptr_ != rhs.ptr_; }
+    bool operator<(traced_iterator const& rhs) const noexcept { return ptr_ < rhs.ptr_; }
+    bool operator>(traced_iterator const& rhs) const noexcept { return ptr_ > rhs.ptr_; }
+    bool operator<=(traced_iterator const& rhs) const noexcept { return ptr_ <= rhs.ptr_; }
+    bool operator>=(traced_iterator const& rhs) const noexcept { return ptr_ >= rhs.ptr_; }
+
+    // Untraced pointer, e.g. to pass the position back to slice().
+    T const* base() const noexcept
+    {
+        return ptr_;
+    }
+
+private:
+    T const* ptr_;
+    // A copy keyed by the label, so the iterator stays valid after its view is gone.
+    trace::detail::probe probe_;
+};
+// }}}
+
+// traced_array_view {{{
+template<class T>
+class traced_array_view : public array_view<T> {
+    typedef array_view<T> base_type;
+public:
+    typedef traced_iterator<T> iterator;
+    typedef traced_iterator<T> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef typename base_type::size_type size_type;
+    typedef typename base_type::const_reference const_reference;
+    typedef typename base_type::const_pointer const_pointer;
+
+    // label must stay valid while the view, its slices and its iterators are
+    // used.  The counters keep a copy of it, so it may be gone at exit.
+    traced_array_view(char const* const label, base_type const& v)
+        : base_type(v), probe_(label)
+    {
+        ++probe_.stats().instances;
+    }
+
+    traced_array_view(traced_array_view const& other)
+        : base_type(other), probe_(other.probe_.label())
+    {}
+
+    traced_array_view& operator=(traced_array_view const&) = delete;
+
+    /*
+     * iterator interfaces
+     */
+    const_iterator begin() const noexcept
+    {
+        return {base_type::begin(), probe_};
+    }
+    const_iterator end() const noexcept
+    {
+        return {base_type::end(), probe_};
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator{end()};
+    }
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator{begin()};
+    }
+    const_reverse_iterator crbegin() const
+    {
+        return rbegin();
+    }
+    const_reverse_iterator crend() const
+    {
+        return rend();
+    }
+
+    /*
+     * access
+     */
+    const_reference operator[](size_type const n) const
+    {
+        probe_.access(base_type::data() + n);
+        return base_type::operator[](n);
+    }
+    const_reference at(size_type const n) const
+    {
+        const_reference r = base_type::at(n);
+        probe_.access(&r);
+        return r;
+    }
+    const_reference front() const
+    {
+        probe_.access(base_type::data());
+        return base_type::front();
+    }
+    const_reference back() const
+    {
+        probe_.access(base_type::data() + base_type::size() - 1);
+        return base_type::back();
+    }
+
+    /*
+     * slices
+     */
+    template<class... Args>
+    traced_array_view slice(Args const&... args) const
+    {
+        return sliced(base_type::slice(untraced(args)...));
+    }
+    template<class... Args>
+    traced_array_view slice_before(Args const&... args) const
+    {
+        return sliced(base_type::slice_before(untraced(args)...));
+    }
+    template<class... Args>
+    traced_array_view slice_after(Args const&... args) const
+    {
+        return sliced(base_type::slice_after(untraced(args)...));
+    }
+
+    /*
+     * others
+     */
+    template<class Allocator = std::allocator<T>>
+    auto to_vector(Allocator const& alloc = Allocator{}) const
+        -> std::vector<T, Allocator>
+    {
+        probe_.stats().to_vector_bytes += base_type::size() * sizeof(T);
+        return base_type::to_vector(alloc);
+    }
+
+    char const* label() const noexcept
+    {
+        return probe_.label();
+    }
+
+private:
+    template<class U>
+    static U const& untraced(U const& u) noexcept
+    {
+        return u;
+    }
+    static T const* untraced(const_iterator const& i) noexcept
+    {
+        return i.base();
+    }
+
+    traced_array_view sliced(base_type const& v) const
+    {
+        ++probe_.stats().slices;
+        return traced_array_view{v, probe_.label()};
+    }
+
+    // Slices count as the same view, not as a new instance.
+    traced_array_view(base_type const& v, char const* const label)
+        : base_type(v), probe_(label)
+    {}
+
+    trace::detail::probe probe_;
+};
+// }}}
+
+} // namespace arv
+
+#else
+
+namespace arv {
+
+// traced_array_view {{{
+template<class T>
+class traced_array_view : public array_view<T> {
+    typedef array_view<T> base_type;
+public:
+    constexpr traced_array_view(char const*, base_type const& v) noexcept
+        : base_type(v)
+    {}
+
+    constexpr char const* label() const noexcept
+    {
+        return "";
+    }
+
+    /*
+     * slices
+     */
+    // Return traced views as with tracing enabled, so both builds accept the same code.
+    template<class... Args>
+    constexpr traced_array_view slice(Args const&... args) const
+    {
+        return traced_array_view{"", base_type::slice(args...)};
+    }
+    template<class... Args>
+    constexpr traced_array_view slice_before(Args const&... args) const
+    {
+        return traced_array_view{"", base_type::slice_before(args...)};
+    }
+    template<class... Args>
+    constexpr traced_array_view slice_after(Args const&... args) const
+    {
+        return traced_array_view{"", base_type::slice_after(args...)};
+    }
+};
+// }}}
+
+} // namespace arv
+
+#endif
+
+namespace arv {
+
+// helpers to construct view {{{
+// The label must outlive the returned view, see traced_array_view.
+template<class T>
+inline
+traced_array_view<T> make_traced_view(char const* const label, array_view<T> const& v)
+{
+    return {label, v};
+}
+
+template<class Array>
+inline
+auto make_traced_view(char const* const label, Array const& a)
+    -> traced_array_view<typename decltype(make_view(a))::value_type>
+{
+    return {label, make_view(a)};
+}
+// }}}
+
+} // namespace arv
+
+#endif    // ARV_ARRAY_VIEW_TRACE_HPP_INCLUDED
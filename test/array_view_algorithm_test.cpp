@@ -0,0 +1,128 @@
+#define BOOST_TEST_MODULE ArrayViewAlgorithmTest
+
+#include <algorithm>
+#include <random>
+#include <limits>
+
+#include "../include/array_view.hpp"
+#include "../include/array_view_algorithm.hpp"
+
+using arv::mutable_array_view;
+using arv::make_mutable_view;
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(array_view_algorithm_test)
+
+namespace {
+    template<class T>
+    std::vector<T> random_values(size_t const n, T const lo, T const hi)
+    {
+        std::mt19937 gen(42);
+        typename std::conditional<
+            std::is_floating_point<T>::value,
+            std::uniform_real_distribution<T>,
+            std::uniform_int_distribution<T>
+        >::type dist(lo, hi);
+        std::vector<T> v(n);
+        for (auto& x : v) {
+            x = dist(gen);
+        }
+        return v;
+    }
+} // namespace
+
+BOOST_AUTO_TEST_CASE(radix_sort_integers) {
+    for (size_t const n : {0, 1, 10, 1000, 100000}) {
+        auto v = random_values<std::int32_t>(n, std::numeric_limits<std::int32_t>::min(), std::numeric_limits<std::int32_t>::max());
+        auto expected = v;
+        std::sort(expected.begin(), expected.end());
+        arv::radix_sort(make_mutable_view(v));
+        BOOST_CHECK(v == expected);
+    }
+
+    auto u = random_values<std::uint64_t>(5000, 0, std::numeric_limits<std::uint64_t>::max());
+    auto expected = u;
+    std::sort(expected.begin(), expected.end());
+    std::vector<std::uint64_t> scratch(u.size());
+    arv::radix_sort(make_mutable_view(u), make_mutable_view(scratch));
+    BOOST_CHECK(u == expected);
+
+    // small keys skip the upper passes
+    auto s = random_values<std::int16_t>(5000, -100, 100);
+    auto expected_s = s;
+    std::sort(expected_s.begin(), expected_s.end());
+    arv::radix_sort(make_mutable_view(s));
+    BOOST_CHECK(s == expected_s);
+}
+
+BOOST_AUTO_TEST_CASE(radix_sort_floats) {
+    auto f = random_values<float>(1000, -1e6f, 1e6f);
+    f.push_back(std::numeric_limits<float>::infinity());
+    f.push_back(-std::numeric_limits<float>::infinity());
+    f.push_back(0.0f);
+    auto expected = f;
+    std::sort(expected.begin(), expected.end());
+    arv::radix_sort(make_mutable_view(f));
+    BOOST_CHECK(f == expected);
+
+    auto d = random_values<double>(1000, -1.0, 1.0);
+    auto expected_d = d;
+    std::sort(expected_d.begin(), expected_d.end());
+    arv::radix_sort(make_mutable_view(d));
+    BOOST_CHECK(d == expected_d);
+}
+
+BOOST_AUTO_TEST_CASE(radix_sort_scratch_too_small) {
+    std::vector<int> v(10), scratch(9);
+    BOOST_CHECK_THROW(arv::radix_sort(make_mutable_view(v), make_mutable_view(scratch)), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_radix_sort) {
+    auto v = random_values<std::uint32_t>(1 << 19, 0, std::numeric_limits<std::uint32_t>::max());
+    auto expected = v;
+    std::sort(expected.begin(), expected.end());
+    arv::parallel_radix_sort(make_mutable_view(v), 4);
+    BOOST_CHECK(v == expected);
+
+    auto f = random_values<double>(1 << 18, -1e9, 1e9);
+    auto expected_f = f;
+    std::sort(expected_f.begin(), expected_f.end());
+    std::vector<double> scratch(f.size());
+    arv::parallel_radix_sort(make_mutable_view(f), make_mutable_view(scratch), 3);
+    BOOST_CHECK(f == expected_f);
+}
+
+BOOST_AUTO_TEST_CASE(stable_partition) {
+    std::vector<int> v = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<int> scratch(v.size());
+    auto mv = make_mutable_view(v);
+    auto const is_even = [](int i) { return i % 2 == 0; };
+    auto const mid = arv::stable_partition(mv, make_mutable_view(scratch), is_even);
+    BOOST_CHECK(mid == mv.begin() + 4);
+    BOOST_CHECK(mv == arv::make_view({2, 4, 6, 8, 1, 3, 5, 7, 9}));
+
+    std::vector<int> w = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto const mid2 = arv::stable_partition(make_mutable_view(w), is_even);
+    BOOST_CHECK(mid2 == w.data() + 4);
+    BOOST_CHECK(w == v);
+}
+
+BOOST_AUTO_TEST_CASE(nth_element) {
+    auto v = random_values<int>(1001, -1000, 1000);
+    auto sorted = v;
+    std::sort(sorted.begin(), sorted.end());
+    auto mv = make_mutable_view(v);
+    arv::nth_element(mv, 500);
+    BOOST_CHECK(v[500] == sorted[500]);
+    BOOST_CHECK(std::all_of(v.begin(), v.begin() + 500, [&](int i) { return i <= v[500]; }));
+    arv::nth_element(mv, 10, std::greater<int>{});
+    BOOST_CHECK(v[10] == sorted[1000 - 10]);
+    BOOST_CHECK_THROW(arv::nth_element(mv, 1001), std::out_of_range);
+    BOOST_CHECK_THROW(arv::nth_element(mutable_array_view<int>{}, 0), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
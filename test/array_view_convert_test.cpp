@@ -0,0 +1,290 @@
+#define BOOST_TEST_MODULE ArrayViewConvertTest
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <numeric>
+
+#include "../include/array_view.hpp"
+#include "../include/array_view_convert.hpp"
+
+using arv::make_view;
+using arv::make_mutable_view;
+using arv::float16;
+using arv::bfloat16;
+using arv::rounding;
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(array_view_convert_test)
+
+namespace {
+    // Compares the bits of the bulk conversion with convert_one() for all
+    // modes, sat selects saturation.
+    template<class To, class From>
+    bool bulk_matches_scalar(std::vector<From> const& src, bool const sat, rounding const r)
+    {
+        std::vector<To> dst(src.size());
+        if (sat) {
+            arv::convert_into(arv::saturate, make_view(src), make_mutable_view(dst), r);
+        } else {
+            arv::convert_into(make_view(src), make_mutable_view(dst), r);
+        }
+        for (size_t i = 0; i < src.size(); ++i) {
+            To const expected = arv::detail::convert_one<From, To>::apply(src[i], r, sat);
+            if (std::memcmp(&dst[i], &expected, sizeof(To)) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<float> interesting_floats()
+    {
+        std::vector<float> f;
+        for (int e = -150; e <= 128; ++e) {
+            for (float const m : {1.0f, 1.37f, 1.5f, 1.99999f}) {
+                f.push_back(std::ldexp(m, e));
+                f.push_back(-std::ldexp(m, e));
+            }
+        }
+        for (float const x : {0.0f, -0.0f, 0.5f, 2.5f, -2.5f, 65504.0f, 65519.0f, 65520.0f, 2147483520.0f, -2147483648.0f}) {
+            f.push_back(x);
+        }
+        f.push_back(std::numeric_limits<float>::max());
+        f.push_back(std::numeric_limits<float>::infinity());
+        f.push_back(-std::numeric_limits<float>::infinity());
+        f.push_back(std::numeric_limits<float>::quiet_NaN());
+        f.push_back(-std::numeric_limits<float>::quiet_NaN());
+        return f;
+    }
+} // namespace
+
+BOOST_AUTO_TEST_CASE(widening) {
+    std::vector<std::int16_t> samples = {0, 1, -1, 32767, -32768, 100, -100, 7, 8, 9, 10};
+    std::vector<float> f(samples.size());
+    auto const r = arv::convert_into(make_view(samples), make_mutable_view(f));
+    BOOST_CHECK(r.size() == samples.size());
+    BOOST_CHECK(std::equal(samples.begin(), samples.end(), f.begin()));
+
+    std::vector<double> d(f.size() + 3, -1.0);
+    BOOST_CHECK(arv::convert_into(make_view(f), make_mutable_view(d)).size() == f.size());
+    BOOST_CHECK(std::equal(f.begin(), f.end(), d.begin()));
+    BOOST_CHECK(d.back() == -1.0);
+
+    std::vector<double> too_small(2);
+    BOOST_CHECK_THROW(arv::convert_into(make_view(f), make_mutable_view(too_small)), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(narrowing) {
+    std::vector<double> d = {1.0 / 3.0, -1.0 / 3.0, 1e300, -1e300, 0.5, 2.0, 3.0, 4.0, 5.0};
+    std::vector<float> f(d.size());
+    arv::convert_into(make_view(d), make_mutable_view(f));
+    BOOST_CHECK(f[0] == static_cast<float>(d[0]));
+    BOOST_CHECK(std::isinf(f[2]));
+
+    arv::convert_into(arv::saturate, make_view(d), make_mutable_view(f), rounding::toward_zero);
+    BOOST_CHECK(f[0] < d[0] && f[0] == std::nextafter(static_cast<float>(d[0]), 0.0f));
+    BOOST_CHECK(f[1] > d[1]);
+    BOOST_CHECK(f[2] == std::numeric_limits<float>::max());
+    BOOST_CHECK(f[3] == -std::numeric_limits<float>::max());
+
+    std::vector<std::int32_t> i32 = {70000, -70000, 5, -5};
+    std::vector<std::int16_t> i16(i32.size());
+    arv::convert_into(arv::saturate, make_view(i32), make_mutable_view(i16));
+    BOOST_CHECK(make_view(i16) == make_view<std::int16_t>({32767, -32768, 5, -5}));
+    std::vector<std::uint8_t> u8(i32.size());
+    arv::convert_into(arv::saturate, make_view(i32), make_mutable_view(u8));
+    BOOST_CHECK(make_view(u8) == make_view<std::uint8_t>({255, 0, 5, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(float_to_integer) {
+    std::vector<float> f = {1.5f, 2.5f, -1.5f, 1e10f, -1e10f, std::numeric_limits<float>::quiet_NaN()};
+    std::vector<std::int32_t> i(f.size());
+    arv::convert_into(arv::saturate, make_view(f), make_mutable_view(i));
+    BOOST_CHECK(make_view(i) == make_view<std::int32_t>({1, 2, -1, 2147483647, -2147483647 - 1, 0}));
+    arv::convert_into(arv::saturate, make_view(f), make_mutable_view(i), rounding::to_nearest_even);
+    BOOST_CHECK(make_view(i) == make_view<std::int32_t>({2, 2, -2, 2147483647, -2147483647 - 1, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(float16_conversion) {
+    BOOST_CHECK(float16(1.0f).bits == 0x3c00);
+    BOOST_CHECK(float16(-2.0f).bits == 0xc000);
+    BOOST_CHECK(float16(65504.0f).bits == 0x7bff);
+    BOOST_CHECK(float16(65520.0f).bits == 0x7c00);
+    BOOST_CHECK(float16(std::ldexp(1.0f, -24)).bits == 0x0001);
+    BOOST_CHECK(float16(std::ldexp(1.0f, -25)).bits == 0x0000);
+    BOOST_CHECK(float16(1.0f + std::ldexp(1.0f, -11)).bits == 0x3c00); // tie to even
+    BOOST_CHECK(float16(1.0f + 3 * std::ldexp(1.0f, -11)).bits == 0x3c02);
+    BOOST_CHECK(static_cast<float>(float16::from_bits(0x3555)) == 0.333251953125f);
+    BOOST_CHECK(static_cast<float>(float16::from_bits(0x0001)) == std::ldexp(1.0f, -24));
+    BOOST_CHECK(std::isnan(static_cast<float>(float16(std::numeric_limits<float>::quiet_NaN()))));
+
+    // Bulk conversion must match the scalar one for every value.
+    std::vector<float16> all(0x10000);
+    for (std::uint32_t i = 0; i < all.size(); ++i) {
+        all[i] = float16::from_bits(static_cast<std::uint16_t>(i));
+    }
+    std::vector<float> f(all.size());
+    arv::convert_into(make_view(all), make_mutable_view(f));
+    std::vector<float16> back(all.size());
+    arv::convert_into(make_view(f), make_mutable_view(back));
+    bool decode_ok = true;
+    bool roundtrip_ok = true;
+    for (size_t i = 0; i < all.size(); ++i) {
+        // Compare bits, NaN payloads must match as well.
+        float const expected = static_cast<float>(all[i]);
+        decode_ok = decode_ok && std::memcmp(&f[i], &expected, sizeof(float)) == 0;
+        // Signaling NaNs are quieted.
+        bool const is_nan = (all[i].bits & 0x7fff) > 0x7c00;
+        roundtrip_ok = roundtrip_ok && back[i].bits == (is_nan ? all[i].bits | 0x200 : all[i].bits);
+    }
+    BOOST_CHECK(decode_ok);
+    BOOST_CHECK(roundtrip_ok);
+
+    // Values between representable ones
+    std::vector<float> mid(4096);
+    for (size_t i = 0; i < mid.size(); ++i) {
+        mid[i] = std::ldexp(static_cast<float>(i) + 0.37f, static_cast<int>(i % 48) - 30) * (i % 2 ? -1.0f : 1.0f);
+    }
+    std::vector<float16> h(mid.size());
+    arv::convert_into(make_view(mid), make_mutable_view(h));
+    bool encode_ok = true;
+    for (size_t i = 0; i < mid.size(); ++i) {
+        encode_ok = encode_ok && h[i].bits == float16(mid[i]).bits;
+    }
+    BOOST_CHECK(encode_ok);
+
+    // NaNs keep the upper bits of their payload.
+    std::vector<float> nans(64);
+    for (size_t i = 0; i < nans.size(); ++i) {
+        std::uint32_t const u = 0x7f800000u | (i % 2 ? 0x80000000u : 0u) | static_cast<std::uint32_t>(i * 0x1e6f1 + 1);
+        std::memcpy(&nans[i], &u, sizeof(float));
+    }
+    std::vector<float16> hn(nans.size());
+    arv::convert_into(make_view(nans), make_mutable_view(hn));
+    bool nan_ok = true;
+    for (size_t i = 0; i < nans.size(); ++i) {
+        nan_ok = nan_ok && hn[i].bits == float16(nans[i]).bits;
+    }
+    BOOST_CHECK(nan_ok);
+    BOOST_CHECK(float16(nans[2]).bits == (0x7e00 | ((2 * 0x1e6f1 + 1) >> 13)));
+
+    std::vector<float> big = {1e6f, -1e6f, 65519.0f, 1.00097f};
+    std::vector<float16> hs(big.size());
+    arv::convert_into(arv::saturate, make_view(big), make_mutable_view(hs));
+    BOOST_CHECK(hs[0].bits == 0x7bff && hs[1].bits == 0xfbff && hs[2].bits == 0x7bff);
+    arv::convert_into(make_view(big), make_mutable_view(hs), rounding::toward_zero);
+    BOOST_CHECK(hs[0].bits == 0x7bff && hs[3].bits == 0x3c00);
+}
+
+BOOST_AUTO_TEST_CASE(bfloat16_conversion) {
+    BOOST_CHECK(bfloat16(1.0f).bits == 0x3f80);
+    BOOST_CHECK(bfloat16(-2.0f).bits == 0xc000);
+    BOOST_CHECK(bfloat16(1.00390625f).bits == 0x3f80); // tie to even
+    BOOST_CHECK(bfloat16(1.01171875f).bits == 0x3f82);
+    BOOST_CHECK(static_cast<float>(bfloat16::from_bits(0x4049)) == 3.140625f);
+
+    std::vector<float> f(1000);
+    for (size_t i = 0; i < f.size(); ++i) {
+        f[i] = std::ldexp(static_cast<float>(i) * 1.37f, static_cast<int>(i % 200) - 100) * (i % 3 ? 1.0f : -1.0f);
+    }
+    f[5] = std::numeric_limits<float>::quiet_NaN();
+    f[6] = std::numeric_limits<float>::infinity();
+    f[7] = std::numeric_limits<float>::max();
+    std::vector<bfloat16> b(f.size());
+    arv::convert_into(make_view(f), make_mutable_view(b));
+    bool encode_ok = true;
+    for (size_t i = 0; i < f.size(); ++i) {
+        encode_ok = encode_ok && b[i].bits == bfloat16(f[i]).bits;
+    }
+    BOOST_CHECK(encode_ok);
+    BOOST_CHECK(std::isnan(static_cast<float>(b[5])));
+    BOOST_CHECK(b[7].bits == 0x7f80);
+
+    std::vector<float> back(b.size());
+    arv::convert_into(make_view(b), make_mutable_view(back));
+    bool decode_ok = true;
+    for (size_t i = 0; i < b.size(); ++i) {
+        decode_ok = decode_ok && (i == 5 || back[i] == static_cast<float>(b[i]));
+    }
+    BOOST_CHECK(decode_ok);
+
+    std::vector<bfloat16> bs(f.size());
+    arv::convert_into(arv::saturate, make_view(f), make_mutable_view(bs));
+    BOOST_CHECK(bs[7].bits == 0x7f7f);
+    BOOST_CHECK(bs[6].bits == 0x7f80);
+}
+
+BOOST_AUTO_TEST_CASE(simd_matches_scalar) {
+    auto const f = interesting_floats();
+    for (bool const sat : {false, true}) {
+        BOOST_CHECK(bulk_matches_scalar<float16>(f, sat, rounding::to_nearest_even));
+        BOOST_CHECK(bulk_matches_scalar<float16>(f, sat, rounding::toward_zero));
+        BOOST_CHECK(bulk_matches_scalar<bfloat16>(f, sat, rounding::to_nearest_even));
+        BOOST_CHECK(bulk_matches_scalar<bfloat16>(f, sat, rounding::toward_zero));
+    }
+
+    // Out of range values are undefined without saturation.
+    std::vector<float> in_range;
+    std::copy_if(f.begin(), f.end(), std::back_inserter(in_range), [](float const x) {
+        return x >= -2147483648.0f && x < 2147483648.0f;
+    });
+    for (auto const r : {rounding::to_nearest_even, rounding::toward_zero}) {
+        BOOST_CHECK(bulk_matches_scalar<std::int32_t>(f, true, r));
+        BOOST_CHECK(bulk_matches_scalar<std::int32_t>(in_range, false, r));
+    }
+
+    std::vector<std::int32_t> i;
+    for (std::int64_t x = -100000; x <= 100000; x += 997) {
+        i.push_back(static_cast<std::int32_t>(x));
+    }
+    i.push_back(std::numeric_limits<std::int32_t>::max());
+    i.push_back(std::numeric_limits<std::int32_t>::min());
+    BOOST_CHECK(bulk_matches_scalar<std::int16_t>(i, true, rounding::to_nearest_even));
+    BOOST_CHECK(bulk_matches_scalar<std::int16_t>(i, false, rounding::to_nearest_even));
+}
+
+BOOST_AUTO_TEST_CASE(array_sources) {
+    std::vector<std::int16_t> const samples = {1, -2, 3};
+    std::vector<float> f(samples.size());
+    BOOST_CHECK(arv::convert_into(samples, make_mutable_view(f)) == make_view({1.0f, -2.0f, 3.0f}));
+
+    float const big[] = {0.4f, 300.0f, -300.0f};
+    std::vector<std::int8_t> i8(3);
+    arv::convert_into(arv::saturate, big, make_mutable_view(i8), rounding::to_nearest_even);
+    BOOST_CHECK(i8 == std::vector<std::int8_t>({0, 127, -128}));
+
+    std::array<double, 2> const d = {{1.5, -2.5}};
+    BOOST_CHECK(arv::make_converted_view<float>(d).to_vector() == std::vector<float>({1.5f, -2.5f}));
+    BOOST_CHECK(arv::make_converted_view<double>(samples).to_vector() == std::vector<double>({1, -2, 3}));
+    auto const sv = arv::make_converted_view<std::int8_t>(arv::saturate, big);
+    BOOST_CHECK(sv.to_vector() == std::vector<std::int8_t>({0, 127, -128}));
+}
+
+BOOST_AUTO_TEST_CASE(converted_view) {
+    std::vector<std::int16_t> samples = {1, -2, 3, -4, 5};
+    auto cv = arv::make_converted_view<double>(make_view(samples));
+    BOOST_CHECK(cv.size() == 5);
+    BOOST_CHECK(cv[1] == -2.0);
+    BOOST_CHECK(cv.at(4) == 5.0);
+    BOOST_CHECK_THROW(cv.at(5), std::out_of_range);
+    BOOST_CHECK(std::accumulate(cv.begin(), cv.end(), 0.0) == 3.0);
+    BOOST_CHECK(cv.to_vector() == std::vector<double>({1, -2, 3, -4, 5}));
+
+    std::vector<float> f = {0.4f, 0.6f, 300.0f, -300.0f};
+    auto rv = arv::make_converted_view<std::int8_t>(arv::saturate, make_view(f), rounding::to_nearest_even);
+    BOOST_CHECK(rv.to_vector() == std::vector<std::int8_t>({0, 1, 127, -128}));
+
+    std::vector<float16> h(f.size());
+    arv::make_converted_view<float16>(make_view(f)).convert_into(make_mutable_view(h));
+    BOOST_CHECK(h[2].bits == float16(300.0f).bits);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
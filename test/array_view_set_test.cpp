@@ -0,0 +1,120 @@
+#define BOOST_TEST_MODULE ArrayViewSetTest
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+
+#include "../include/array_view.hpp"
+#include "../include/array_view_set.hpp"
+
+using arv::array_view;
+using arv::make_view;
+using arv::make_mutable_view;
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(array_view_set_test)
+
+namespace {
+    std::vector<std::uint32_t> random_set(size_t const n, std::uint32_t const max, unsigned const seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<std::uint32_t> dist(0, max);
+        std::set<std::uint32_t> s;
+        while (s.size() < n) {
+            s.insert(dist(gen));
+        }
+        return {s.begin(), s.end()};
+    }
+
+    // Pairs of sizes covering the merge, SIMD and galloping paths.
+    std::vector<std::pair<size_t, size_t>> const sizes = {
+        {0, 0}, {0, 10}, {1, 1}, {3, 5}, {7, 9}, {100, 120}, {1000, 1000}, {10, 5000}, {5000, 10}, {1, 3000}
+    };
+} // namespace
+
+BOOST_AUTO_TEST_CASE(intersect) {
+    unsigned seed = 0;
+    for (auto const& s : sizes) {
+        auto const a = random_set(s.first, 10000, ++seed);
+        auto const b = random_set(s.second, 10000, ++seed);
+        std::vector<std::uint32_t> expected;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+        std::vector<std::uint32_t> out(std::min(a.size(), b.size()));
+        auto const r = arv::intersect(a, b, make_mutable_view(out));
+        BOOST_CHECK(r == expected);
+        BOOST_CHECK(arv::intersect_count(make_view(a), b) == expected.size());
+        BOOST_CHECK(arv::intersect_count(a, b) == expected.size());
+        BOOST_CHECK(arv::intersect_count(a, make_view(b)) == expected.size());
+    }
+
+    // signed and non SIMD element types
+    std::vector<int> const a = {-5, -3, 0, 2, 4, 6, 8};
+    std::vector<int> const b = {-3, -2, 2, 3, 8, 9};
+    std::vector<int> out(6);
+    BOOST_CHECK(arv::intersect(a, b, make_mutable_view(out)) == make_view({-3, 2, 8}));
+    std::vector<double> const da = {0.5, 1.0, 1.5};
+    std::vector<double> const db = {1.0, 2.0};
+    std::vector<double> dout(2);
+    BOOST_CHECK(arv::intersect(da, db, make_mutable_view(dout)) == make_view({1.0}));
+
+    std::vector<int> small(2);
+    BOOST_CHECK_THROW(arv::intersect(a, b, make_mutable_view(small)), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(intersect_k_way) {
+    auto const a = random_set(2000, 5000, 1);
+    auto const b = random_set(3000, 5000, 2);
+    auto const c = random_set(1500, 5000, 3);
+    auto const d = random_set(4000, 5000, 4);
+    std::vector<std::uint32_t> ab, abc, expected;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(ab));
+    std::set_intersection(ab.begin(), ab.end(), c.begin(), c.end(), std::back_inserter(abc));
+    std::set_intersection(abc.begin(), abc.end(), d.begin(), d.end(), std::back_inserter(expected));
+    BOOST_CHECK(!expected.empty());
+
+    std::vector<std::uint32_t> out(c.size());
+    std::vector<array_view<std::uint32_t>> lists = {a, b, c, d};
+    BOOST_CHECK(arv::intersect(make_view(lists), make_mutable_view(out)) == expected);
+
+    std::vector<array_view<std::uint32_t>> single = {a};
+    std::vector<std::uint32_t> out2(a.size());
+    BOOST_CHECK(arv::intersect(make_view(single), make_mutable_view(out2)) == a);
+
+    std::vector<array_view<std::uint32_t>> none;
+    BOOST_CHECK(arv::intersect(make_view(none), make_mutable_view(out2)).empty());
+    BOOST_CHECK_THROW(arv::intersect(make_view(lists), make_mutable_view(out).slice_before(10)), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(unite) {
+    unsigned seed = 100;
+    for (auto const& s : sizes) {
+        auto const a = random_set(s.first, 10000, ++seed);
+        auto const b = random_set(s.second, 10000, ++seed);
+        std::vector<std::uint32_t> expected;
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+        std::vector<std::uint32_t> out(a.size() + b.size());
+        BOOST_CHECK(arv::unite(a, b, make_mutable_view(out)) == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(difference) {
+    unsigned seed = 200;
+    for (auto const& s : sizes) {
+        auto const a = random_set(s.first, 10000, ++seed);
+        auto const b = random_set(s.second, 10000, ++seed);
+        std::vector<std::uint32_t> expected;
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+        std::vector<std::uint32_t> out(a.size());
+        BOOST_CHECK(arv::difference(a, b, make_mutable_view(out)) == expected);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,156 @@
+#define BOOST_TEST_MODULE ArrayViewStreamTest
+
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <thread>
+
+#include <unistd.h>
+
+#include "../include/array_view.hpp"
+#include "../include/array_view_stream.hpp"
+
+using arv::array_view;
+using arv::stream_reader;
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(array_view_stream_test)
+
+namespace {
+    struct record {
+        std::uint32_t id;
+        std::uint32_t value;
+        std::uint32_t check;
+    };
+
+    std::vector<record> make_records(size_t const n)
+    {
+        std::vector<record> v(n);
+        for (size_t i = 0; i < n; ++i) {
+            v[i] = record{static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(i * 7), static_cast<std::uint32_t>(i ^ 0x5555)};
+        }
+        return v;
+    }
+
+    bool check_records(std::vector<record> const& v)
+    {
+        for (size_t i = 0; i < v.size(); ++i) {
+            if (v[i].id != i || v[i].value != i * 7 || v[i].check != (i ^ 0x5555)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct temp_file {
+        explicit temp_file(void const* const data, size_t const bytes)
+            : file(std::tmpfile())
+        {
+            std::fwrite(data, 1, bytes, file);
+            std::fflush(file);
+        }
+        ~temp_file()
+        {
+            std::fclose(file);
+        }
+        int fd() const
+        {
+            return fileno(file);
+        }
+        std::FILE* file;
+    };
+} // namespace
+
+BOOST_AUTO_TEST_CASE(read_from_pipe) {
+    auto const records = make_records(10000);
+    int fds[2];
+    BOOST_REQUIRE(::pipe(fds) == 0);
+
+    // Write in chunks which split records.
+    std::thread writer([&] {
+        auto const* p = reinterpret_cast<char const*>(records.data());
+        size_t left = records.size() * sizeof(record);
+        while (left != 0) {
+            auto const n = ::write(fds[1], p, std::min<size_t>(left, 1000));
+            p += n;
+            left -= n;
+        }
+        ::close(fds[1]);
+    });
+
+    std::vector<record> received;
+    size_t batches = 0;
+    {
+        // 4096 bytes are not a multiple of 12, records are carried over.
+        stream_reader<record> reader(fds[0], 4096, 3);
+        while (auto b = reader.next()) {
+            array_view<record> av = b;
+            received.insert(received.end(), av.begin(), av.end());
+            ++batches;
+        }
+        BOOST_CHECK(reader.next().empty());
+    }
+    writer.join();
+    ::close(fds[0]);
+
+    BOOST_CHECK(received.size() == records.size());
+    BOOST_CHECK(check_records(received));
+    BOOST_CHECK(batches >= records.size() * sizeof(record) / 4096);
+}
+
+BOOST_AUTO_TEST_CASE(destroy_while_writer_is_open) {
+    int fds[2];
+    BOOST_REQUIRE(::pipe(fds) == 0);
+    {
+        stream_reader<record> reader(fds[0], 4096, 2);
+        // Part of a buffer arrives, then the writer goes quiet without closing its end.
+        auto const records = make_records(10);
+        BOOST_REQUIRE(::write(fds[1], records.data(), sizeof(record) * records.size()) > 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    {
+        stream_reader<record> reader(fds[0], 4096, 2);
+    }
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+BOOST_AUTO_TEST_CASE(read_with_pread) {
+    std::vector<std::uint64_t> values(100000);
+    std::iota(values.begin(), values.end(), 0);
+    temp_file f(values.data(), values.size() * sizeof(std::uint64_t));
+
+    // Hold two batches at once, starting after the first 10 values.
+    stream_reader<std::uint64_t> reader(f.fd(), 8192, 4, 10 * sizeof(std::uint64_t));
+    std::vector<std::uint64_t> received;
+    auto b1 = reader.next();
+    while (auto b2 = reader.next()) {
+        received.insert(received.end(), b1.view().begin(), b1.view().end());
+        b1 = std::move(b2);
+    }
+    received.insert(received.end(), b1.view().begin(), b1.view().end());
+
+    BOOST_CHECK(received.size() == values.size() - 10);
+    BOOST_CHECK(std::equal(received.begin(), received.end(), values.begin() + 10));
+}
+
+BOOST_AUTO_TEST_CASE(partial_record) {
+    char const data[] = "0123456789";
+    temp_file f(data, 10);
+    stream_reader<std::uint32_t> reader(f.fd(), 4096, 2, 0);
+    auto b = reader.next();
+    BOOST_CHECK(b.size() == 2);
+    b.release();
+    BOOST_CHECK_THROW(reader.next(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_arguments) {
+    BOOST_CHECK_THROW(stream_reader<record>(0, 8), std::invalid_argument);
+    BOOST_CHECK_THROW(stream_reader<record>(0, 4096, 0), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
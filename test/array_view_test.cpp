@@ -2,12 +2,15 @@
 
 #include <sstream>
 #include <list>
+#include <deque>
 
 #include "../include/array_view.hpp"
 #include "../include/array_view_output.hpp"
 
 using arv::array_view;
 using arv::make_view;
+using arv::mutable_array_view;
+using arv::make_mutable_view;
 
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MAIN
@@ -184,4 +187,69 @@ BOOST_AUTO_TEST_CASE(safe_slice) {
     BOOST_CHECK_THROW(av.slice_after(check_bound, av.begin() + 11), std::out_of_range);
 }
 
+BOOST_FIXTURE_TEST_CASE(mutable_view, fixture_1_2_3) {
+    int a[] = {1, 2, 3};
+    std::array<int, 3> ar = {{1, 2, 3}};
+    std::vector<int> v = {1, 2, 3};
+    mutable_array_view<int> mv1 = a;
+    mutable_array_view<int> mv2 = ar;
+    mutable_array_view<int> mv3 = v;
+    mutable_array_view<int> mv4{&a[0], 3};
+    mutable_array_view<int> mv5(v.data(), v.data() + v.size());
+    BOOST_CHECK(is_1_2_3<int>(mv1));
+    BOOST_CHECK(is_1_2_3<int>(mv2));
+    BOOST_CHECK(is_1_2_3<int>(mv3));
+    BOOST_CHECK(is_1_2_3<int>(mv4));
+    BOOST_CHECK(is_1_2_3<int>(mv5));
+    BOOST_CHECK(mutable_array_view<int>{}.empty());
+    BOOST_CHECK(mutable_array_view<int>(v.data(), v.data()).empty());
+    BOOST_CHECK((mutable_array_view<int>{v.data(), 0}).empty());
+    BOOST_CHECK((mutable_array_view<int>{v.data(), 2}).size() == 2);
+    BOOST_CHECK((std::is_constructible<mutable_array_view<int>, int*, int*>::value));
+    BOOST_CHECK((!std::is_constructible<mutable_array_view<int>, std::deque<int>::iterator, std::deque<int>::iterator>::value));
+    BOOST_CHECK((!std::is_constructible<mutable_array_view<int>, std::list<int>::iterator, std::list<int>::iterator>::value));
+
+    // write through the view
+    mv3[0] = 4;
+    mv3.back() = 6;
+    mv3.at(1) = 5;
+    BOOST_CHECK_THROW(mv3.at(3), std::out_of_range);
+    BOOST_CHECK(v == std::vector<int>({4, 5, 6}));
+    for (auto& i : make_mutable_view(ar)) {
+        i *= 2;
+    }
+    BOOST_CHECK(make_view(ar) == make_view({2, 4, 6}));
+
+    // compare with const views and arrays
+    array_view<int> av = mv3;
+    BOOST_CHECK(av == mv3);
+    BOOST_CHECK(mv3 == av);
+    BOOST_CHECK(mv3 == v);
+    BOOST_CHECK(v == mv3);
+    BOOST_CHECK(mv1 != mv3);
+    BOOST_CHECK(a != mv3);
+    BOOST_CHECK(mv1 == make_mutable_view(&a[0], 3));
+    BOOST_CHECK(mv1 == make_mutable_view(&a[0], &a[0] + 3));
+    BOOST_CHECK(mv3.to_vector() == v);
+}
+
+BOOST_AUTO_TEST_CASE(mutable_view_slice) {
+    std::vector<int> v = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto mv = make_mutable_view(v);
+
+    using arv::check_bound;
+
+    BOOST_CHECK(mv.slice(2, 5) == make_view({3, 4, 5, 6, 7}));
+    BOOST_CHECK(mv.slice_before(5) == make_view({1, 2, 3, 4, 5}));
+    BOOST_CHECK(mv.slice_after(5) == make_view({6, 7, 8, 9}));
+    BOOST_CHECK(mv.slice(mv.begin()+2, mv.begin()+7) == make_view({3, 4, 5, 6, 7}));
+    BOOST_CHECK(mv.slice(check_bound, 2, 5) == make_view({3, 4, 5, 6, 7}));
+    BOOST_CHECK(mv.slice_after(check_bound, mv.begin()+5) == make_view({6, 7, 8, 9}));
+    BOOST_CHECK_THROW(mv.slice(check_bound, 1, 10), std::out_of_range);
+    BOOST_CHECK_THROW(mv.slice_before(check_bound, mv.begin() + 11), std::out_of_range);
+
+    mv.slice(2, 2)[1] = 0;
+    BOOST_CHECK(v[3] == 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,53 @@
+#define BOOST_TEST_MODULE ArrayViewTraceDisabledTest
+
+#include <numeric>
+#include <type_traits>
+
+#include "../include/array_view_trace.hpp"
+
+using arv::array_view;
+using arv::traced_array_view;
+using arv::make_traced_view;
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(array_view_trace_disabled_test)
+
+#if defined ARV_ENABLE_TRACE
+#error "array_view_trace_disabled_test must be built without ARV_ENABLE_TRACE."
+#endif
+
+// Without ARV_ENABLE_TRACE the traced view is a plain array_view.
+static_assert(std::is_base_of<array_view<int>, traced_array_view<int>>::value, "traced_array_view must be an array_view");
+static_assert(sizeof(traced_array_view<int>) == sizeof(array_view<int>), "traced_array_view must not add state");
+static_assert(std::is_same<traced_array_view<int>::const_iterator, int const*>::value, "iterators must be plain pointers");
+
+BOOST_AUTO_TEST_CASE(plain_array_view) {
+    std::vector<int> v = {1, 2, 3, 4, 5};
+    traced_array_view<int> tv{"disabled", v};
+    auto tv2 = make_traced_view("disabled", v);
+    BOOST_CHECK(tv == v);
+    BOOST_CHECK(tv2 == v);
+    BOOST_CHECK(tv[2] == 3);
+    BOOST_CHECK(std::accumulate(tv.begin(), tv.end(), 0) == 15);
+    BOOST_CHECK(tv.slice(1, 2) == arv::make_view({2, 3}));
+    BOOST_CHECK(tv.to_vector() == v);
+    BOOST_CHECK(std::string(tv.label()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(slices_stay_traced_views) {
+    std::vector<int> v = {1, 2, 3, 4, 5};
+    auto tv = make_traced_view("disabled", v);
+    traced_array_view<int> s = tv.slice(1, 2);
+    BOOST_CHECK(s == arv::make_view({2, 3}));
+    traced_array_view<int> b = tv.slice_before(tv.begin() + 2);
+    BOOST_CHECK(b == arv::make_view({1, 2}));
+    traced_array_view<int> a = tv.slice_after(arv::check_bound, 3);
+    BOOST_CHECK(a == arv::make_view({4, 5}));
+    BOOST_CHECK_THROW(tv.slice_after(arv::check_bound, 6), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,155 @@
+#define BOOST_TEST_MODULE ArrayViewTraceTest
+
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <numeric>
+
+// ARV_ENABLE_TRACE is set for this whole test by CMake.
+#if !defined ARV_ENABLE_TRACE
+#error "array_view_trace_test must be built with ARV_ENABLE_TRACE."
+#endif
+#include "../include/array_view_trace.hpp"
+
+using arv::array_view;
+using arv::traced_array_view;
+using arv::make_traced_view;
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(array_view_trace_test)
+
+namespace {
+    int sum(array_view<int> av)
+    {
+        return std::accumulate(av.begin(), av.end(), 0);
+    }
+
+    // Takes the view by value, the returned iterator outlives it.
+    template<class View>
+    typename View::const_iterator find_value(View v, int const x)
+    {
+        return std::find(v.begin(), v.end(), x);
+    }
+} // namespace
+
+BOOST_AUTO_TEST_CASE(drop_in_replacement) {
+    std::vector<int> v = {1, 2, 3, 4, 5};
+    traced_array_view<int> tv{"drop_in", v};
+    BOOST_CHECK(tv.size() == 5);
+    BOOST_CHECK(tv[2] == 3);
+    BOOST_CHECK(tv.at(4) == 5);
+    BOOST_CHECK_THROW(tv.at(5), std::out_of_range);
+    BOOST_CHECK(tv == v);
+    BOOST_CHECK(sum(tv) == 15);
+    BOOST_CHECK(std::accumulate(tv.begin(), tv.end(), 0) == 15);
+    BOOST_CHECK(tv.to_vector() == v);
+    BOOST_CHECK(std::string(tv.label()) == "drop_in");
+}
+
+BOOST_AUTO_TEST_CASE(sequential_scan) {
+    std::vector<int> v(64);
+    auto tv = make_traced_view("sequential", v);
+    int n = 0;
+    for (auto const i : tv) {
+        n += i;
+    }
+    BOOST_CHECK(n == 0);
+
+    auto const s = arv::trace::stats("sequential");
+    BOOST_CHECK(s.instances == 1);
+    BOOST_CHECK(s.accesses == 64);
+    BOOST_CHECK(s.forward_strides[1] == 63);
+    BOOST_CHECK(s.cache_lines.estimate() >= 64 * sizeof(int) / ARV_TRACE_CACHE_LINE_SIZE);
+    BOOST_CHECK(s.cache_lines.estimate() <= 64 * sizeof(int) / ARV_TRACE_CACHE_LINE_SIZE + 1);
+}
+
+BOOST_AUTO_TEST_CASE(distinct_cache_lines_estimate) {
+    // One access per cache line over 20000 lines, twice.
+    size_t const stride = ARV_TRACE_CACHE_LINE_SIZE / sizeof(int);
+    std::vector<int> v(20000 * stride);
+    auto tv = make_traced_view("lines", v);
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = 0; i < v.size(); i += stride) {
+            tv[i];
+        }
+    }
+
+    auto const s = arv::trace::stats("lines");
+    BOOST_CHECK(s.accesses == 40000);
+    double const e = static_cast<double>(s.cache_lines.estimate());
+    BOOST_CHECK(e > 20000 * 0.9 && e < 20000 * 1.1);
+}
+
+BOOST_AUTO_TEST_CASE(random_access) {
+    std::vector<int> v(1024);
+    auto tv = make_traced_view("random", v);
+    tv[0];
+    tv[512];
+    tv[256];
+    tv[256];
+
+    auto const s = arv::trace::stats("random");
+    BOOST_CHECK(s.accesses == 4);
+    BOOST_CHECK(s.forward_strides[10] == 1); // +512
+    BOOST_CHECK(s.backward_strides[9] == 1); // -256
+    BOOST_CHECK(s.forward_strides[0] == 1);  // same element
+}
+
+BOOST_AUTO_TEST_CASE(iterator_outlives_view) {
+    std::vector<int> v = {1, 2, 3, 4, 5};
+    auto const itr = find_value(make_traced_view("outlive", v), 3);
+    BOOST_CHECK(*itr == 3);
+    BOOST_CHECK(itr[1] == 4);
+
+    auto const s = arv::trace::stats("outlive");
+    BOOST_CHECK(s.instances == 1);
+    BOOST_CHECK(s.accesses == 5);
+}
+
+BOOST_AUTO_TEST_CASE(label_outlived_by_counters) {
+    std::vector<int> v = {1, 2, 3};
+    {
+        std::string label = "temporary";
+        label += "_label";
+        auto tv = make_traced_view(label.c_str(), v);
+        tv[1];
+    }
+    auto const s = arv::trace::stats("temporary_label");
+    BOOST_CHECK(s.instances == 1);
+    BOOST_CHECK(s.accesses == 1);
+}
+
+BOOST_AUTO_TEST_CASE(slices_and_copies) {
+    std::vector<int> v = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto tv = make_traced_view("slices", v);
+    traced_array_view<int> sub = tv.slice(2, 5);
+    BOOST_CHECK(sub == arv::make_view({3, 4, 5, 6, 7}));
+    auto sub2 = sub.slice_before(sub.begin() + 2);
+    BOOST_CHECK(sub2 == arv::make_view({3, 4}));
+    BOOST_CHECK_THROW(tv.slice_after(arv::check_bound, 10), std::out_of_range);
+    sub2.to_vector();
+
+    auto const s = arv::trace::stats("slices");
+    BOOST_CHECK(s.instances == 1);
+    BOOST_CHECK(s.slices == 2);
+    BOOST_CHECK(s.to_vector_bytes == 2 * sizeof(int));
+}
+
+BOOST_AUTO_TEST_CASE(json_output) {
+    std::vector<int> v = {1, 2, 3};
+    auto tv = make_traced_view("json \"quoted\"", v);
+    tv.front();
+    tv.back();
+
+    std::stringstream ss;
+    arv::trace::dump(ss);
+    auto const json = ss.str();
+    BOOST_CHECK(json.find("\"label\": \"json \\\"quoted\\\"\", \"instances\": 1, \"accesses\": 2") != std::string::npos);
+    BOOST_CHECK(json.find("\"+2\": 1") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()